@@ -0,0 +1,78 @@
+#include "benchmark_utility.hpp"
+
+#include <interval-tree/interval_tree_parallel.hpp>
+
+#include <cstdlib>
+#include <vector>
+
+using namespace lib_interval_tree;
+using namespace benchmark_utility;
+
+/**
+ *  Compares one overlap_find_all per query with overlap_find_batch and overlap_find_batch_sorted over all queries,
+ *  and with parallel_overlap_find_batch on all hardware threads.
+ *  Usage: bench-batch_queries [interval count] [query count]
+ */
+int main(int argc, char** argv)
+{
+    const std::size_t count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 4000000;
+    const std::size_t queries = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 1000000;
+    const int range = static_cast<int>(count) * 10;
+
+    const auto intervals = random_intervals(count, range, 100);
+    const auto query_intervals = random_intervals(queries, range, 10, 7);
+
+    interval_tree<interval_type> tree;
+    for (auto const& ival : intervals)
+        tree.insert(ival);
+
+    long long found = 0;
+    double elapsed = time_ms([&] {
+        for (auto const& query : query_intervals)
+        {
+            tree.overlap_find_all(query, [&found](interval_tree<interval_type>::iterator iter) {
+                found += iter->low();
+                return true;
+            });
+        }
+    });
+    do_not_optimize(found);
+    report("overlap_find_all per query", elapsed, queries, found);
+
+    found = 0;
+    elapsed = time_ms([&] {
+        tree.overlap_find_batch(query_intervals, [&found](std::size_t, interval_tree<interval_type>::iterator iter) {
+            found += iter->low();
+            return true;
+        });
+    });
+    do_not_optimize(found);
+    report("overlap_find_batch", elapsed, queries, found);
+
+    found = 0;
+    elapsed = time_ms([&] {
+        tree.overlap_find_batch_sorted(
+            query_intervals,
+            [&found](std::size_t, interval_tree<interval_type>::iterator iter) {
+                found += iter->low();
+                return true;
+            }
+        );
+    });
+    do_not_optimize(found);
+    report("overlap_find_batch_sorted", elapsed, queries, found);
+
+    std::vector<std::vector<interval_type>> results;
+    found = 0;
+    elapsed = time_ms([&] {
+        parallel_overlap_find_batch(tree, query_intervals, results);
+        for (auto const& result : results)
+        {
+            for (auto const& ival : result)
+                found += ival.low();
+        }
+    });
+    do_not_optimize(found);
+    report("parallel_overlap_find_batch", elapsed, queries, found);
+    return 0;
+}
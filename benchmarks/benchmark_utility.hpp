@@ -0,0 +1,69 @@
+#pragma once
+
+#include <interval-tree/interval_tree.hpp>
+
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+namespace benchmark_utility
+{
+    using interval_type = lib_interval_tree::interval<int>;
+
+    /**
+     *  Intervals with uniformly distributed lows in [0, range) and lengths in [0, max_length].
+     */
+    inline std::vector<interval_type> random_intervals(std::size_t count, int range, int max_length, unsigned seed = 42)
+    {
+        std::mt19937 gen{seed};
+        std::uniform_int_distribution<int> low_dist{0, range - 1};
+        std::uniform_int_distribution<int> length_dist{0, max_length};
+
+        std::vector<interval_type> result;
+        result.reserve(count);
+        for (std::size_t i = 0; i != count; ++i)
+        {
+            const auto low = low_dist(gen);
+            result.push_back({low, low + length_dist(gen)});
+        }
+        return result;
+    }
+
+    /**
+     *  Runs function once and returns the elapsed wall clock time in milliseconds.
+     */
+    template <typename FunctionT>
+    double time_ms(FunctionT&& function)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        function();
+        const auto end = std::chrono::steady_clock::now();
+        return std::chrono::duration<double, std::milli>(end - start).count();
+    }
+
+    inline void report(char const* name, double milliseconds, std::size_t operations, long long checksum)
+    {
+        std::printf(
+            "%-40s %10.2f ms %10.1f ns/op   (checksum %lld)\n",
+            name,
+            milliseconds,
+            milliseconds * 1e6 / static_cast<double>(operations),
+            checksum
+        );
+    }
+
+    /**
+     *  Keeps the optimizer from dropping unused results.
+     */
+    template <typename T>
+    void do_not_optimize(T const& value)
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        asm volatile("" : : "g"(&value) : "memory");
+#else
+        static volatile T const* sink;
+        sink = &value;
+#endif
+    }
+}
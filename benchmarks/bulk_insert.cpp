@@ -0,0 +1,56 @@
+#include "benchmark_utility.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+
+using namespace lib_interval_tree;
+using namespace benchmark_utility;
+
+/**
+ *  Compares building and growing a tree one insert at a time with assign and insert_bulk.
+ *  Usage: bench-bulk_insert [interval count] [batch size]
+ */
+int main(int argc, char** argv)
+{
+    const std::size_t count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 4000000;
+    const std::size_t batch_size = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 500000;
+    const int range = static_cast<int>(count) * 10;
+
+    auto intervals = random_intervals(count, range, 100);
+    const auto batch = random_intervals(batch_size, range, 100, 7);
+
+    interval_tree_t<int> inserted;
+    double elapsed = time_ms([&] {
+        for (auto const& ival : intervals)
+            inserted.insert(ival);
+    });
+    report("insert one by one", elapsed, count, inserted.size());
+
+    interval_tree_t<int> assigned;
+    elapsed = time_ms([&] {
+        assigned.assign_unsorted(intervals.begin(), intervals.end());
+    });
+    report("assign_unsorted", elapsed, count, assigned.size());
+
+    std::sort(intervals.begin(), intervals.end(), [](auto const& lhs, auto const& rhs) {
+        return lhs.low() < rhs.low();
+    });
+    interval_tree_t<int> assigned_sorted;
+    elapsed = time_ms([&] {
+        assigned_sorted.assign(intervals.begin(), intervals.end());
+    });
+    report("assign (presorted)", elapsed, count, assigned_sorted.size());
+
+    elapsed = time_ms([&] {
+        for (auto const& ival : batch)
+            inserted.insert(ival);
+    });
+    report("batch insert one by one", elapsed, batch_size, inserted.size());
+
+    elapsed = time_ms([&] {
+        assigned.insert_bulk(batch.begin(), batch.end());
+    });
+    report("insert_bulk", elapsed, batch_size, assigned.size());
+
+    return 0;
+}
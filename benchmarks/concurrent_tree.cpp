@@ -0,0 +1,79 @@
+#include "benchmark_utility.hpp"
+
+#include <interval-tree/concurrent_interval_tree.hpp>
+
+#include <cstdlib>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace lib_interval_tree;
+using namespace benchmark_utility;
+
+/**
+ *  Inserts intervals from several threads, once into an interval_tree behind one mutex, once into a
+ *  concurrent_interval_tree with insert and once with insert_async followed by flush.
+ *  Usage: bench-concurrent_tree [intervals] [threads] [max length]
+ */
+int main(int argc, char** argv)
+{
+    const std::size_t count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+    const unsigned threads = argc > 2 ? static_cast<unsigned>(std::strtoul(argv[2], nullptr, 10)) : 4;
+    const int max_length = argc > 3 ? std::atoi(argv[3]) : 100;
+    const int range = static_cast<int>(count) * 10;
+
+    const auto intervals = random_intervals(count, range, max_length);
+
+    const auto run = [&](auto const& insert, auto const& finish) {
+        std::vector<std::thread> pool;
+        for (unsigned t = 0; t != threads; ++t)
+        {
+            pool.emplace_back([&, t] {
+                for (auto i = t; i < intervals.size(); i += threads)
+                    insert(intervals[i]);
+                finish();
+            });
+        }
+        for (auto& thread : pool)
+            thread.join();
+    };
+    const auto nothing = [] {};
+
+    interval_tree<interval_type> tree;
+    std::mutex mutex;
+    double elapsed = time_ms([&] {
+        run(
+            [&](interval_type const& ival) {
+                std::lock_guard<std::mutex> lock{mutex};
+                tree.insert(ival);
+            },
+            nothing
+        );
+    });
+    report("interval_tree with one mutex", elapsed, count, static_cast<long long>(tree.size()));
+
+    concurrent_interval_tree<interval_type> waiting;
+    elapsed = time_ms([&] {
+        run(
+            [&](interval_type const& ival) {
+                waiting.insert(ival);
+            },
+            nothing
+        );
+    });
+    report("concurrent_interval_tree insert", elapsed, count, static_cast<long long>(waiting.size()));
+
+    concurrent_interval_tree<interval_type> batched;
+    elapsed = time_ms([&] {
+        run(
+            [&](interval_type const& ival) {
+                batched.insert_async(ival);
+            },
+            [&] {
+                batched.flush();
+            }
+        );
+    });
+    report("concurrent_interval_tree insert_async", elapsed, count, static_cast<long long>(batched.size()));
+    return 0;
+}
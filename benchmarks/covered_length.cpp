@@ -0,0 +1,64 @@
+#include "benchmark_utility.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+
+using namespace lib_interval_tree;
+using namespace benchmark_utility;
+
+/**
+ *  Measures how much of random windows is covered, once by summing the sizes of a deoverlapped copy that is cut to
+ *  the window and once with covered_length on a tree that keeps union measures.
+ *  Usage: bench-covered_length [intervals] [windows] [window length]
+ */
+int main(int argc, char** argv)
+{
+    const std::size_t count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+    const std::size_t window_count = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 10;
+    const int window_length = argc > 3 ? std::atoi(argv[3]) : static_cast<int>(count);
+    const int range = static_cast<int>(count) * 10;
+
+    using measured_tree = interval_tree<interval_type, hooks::with_augmentation<augmentations::union_measure<int>>>;
+
+    const auto intervals = random_intervals(count, range, 100);
+    const auto windows = random_intervals(window_count, range, window_length, 7);
+
+    interval_tree<interval_type> tree;
+    measured_tree measured;
+    double elapsed = time_ms([&] {
+        for (auto const& ival : intervals)
+            tree.insert(ival);
+    });
+    report("insert, plain", elapsed, count, static_cast<long long>(tree.size()));
+    elapsed = time_ms([&] {
+        for (auto const& ival : intervals)
+            measured.insert(ival);
+    });
+    report("insert, with union measure", elapsed, count, static_cast<long long>(measured.size()));
+
+    long long covered = 0;
+    elapsed = time_ms([&] {
+        for (auto const& window : windows)
+        {
+            for (auto const& ival : tree.deoverlap_copy())
+            {
+                if (ival.overlaps(window))
+                {
+                    const interval_type part{std::max(ival.low(), window.low()), std::min(ival.high(), window.high())};
+                    covered += part.size();
+                }
+            }
+        }
+    });
+    do_not_optimize(covered);
+    report("deoverlap_copy and sum", elapsed, windows.size(), covered);
+
+    covered = 0;
+    elapsed = time_ms([&] {
+        for (auto const& window : windows)
+            covered += measured.covered_length(window);
+    });
+    do_not_optimize(covered);
+    report("covered_length", elapsed, windows.size(), covered);
+    return 0;
+}
@@ -0,0 +1,67 @@
+#include "benchmark_utility.hpp"
+
+#include <cstdlib>
+
+using namespace lib_interval_tree;
+using namespace benchmark_utility;
+
+/**
+ *  Jumps to random pages of a tree in ascending order of low, once by incrementing an iterator from begin() and once
+ *  with nth on a tree that keeps subtree sizes.
+ *  Usage: bench-order_statistics [intervals] [jumps]
+ */
+int main(int argc, char** argv)
+{
+    const std::size_t count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+    const std::size_t jumps = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 100;
+    const int range = static_cast<int>(count) * 10;
+
+    const auto intervals = random_intervals(count, range, 100);
+    interval_tree<interval_type> tree;
+    ranked_interval_tree_t<int> ranked;
+    for (auto const& ival : intervals)
+    {
+        tree.insert(ival);
+        ranked.insert(ival);
+    }
+
+    std::mt19937 gen{7};
+    std::uniform_int_distribution<long long> position_dist{0, static_cast<long long>(count) - 1};
+    std::vector<long long> positions;
+    for (std::size_t i = 0; i != jumps; ++i)
+        positions.push_back(position_dist(gen));
+
+    long long checksum = 0;
+    double elapsed = time_ms([&] {
+        for (auto position : positions)
+        {
+            auto iter = tree.begin();
+            for (long long i = 0; i != position; ++i)
+                ++iter;
+            checksum += iter->low();
+        }
+    });
+    do_not_optimize(checksum);
+    report("increment from begin", elapsed, jumps, checksum);
+
+    checksum = 0;
+    elapsed = time_ms([&] {
+        for (auto position : positions)
+            checksum += ranked.nth(position)->low();
+    });
+    do_not_optimize(checksum);
+    report("nth", elapsed, jumps, checksum);
+
+    const auto inserts = random_intervals(count, range, 100, 9);
+    elapsed = time_ms([&] {
+        for (auto const& ival : inserts)
+            tree.insert(ival);
+    });
+    report("insert, plain", elapsed, count, static_cast<long long>(tree.size()));
+    elapsed = time_ms([&] {
+        for (auto const& ival : inserts)
+            ranked.insert(ival);
+    });
+    report("insert, with subtree sizes", elapsed, count, static_cast<long long>(ranked.size()));
+    return 0;
+}
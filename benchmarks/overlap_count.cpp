@@ -0,0 +1,54 @@
+#include "benchmark_utility.hpp"
+
+#include <interval-tree/counting_interval_tree.hpp>
+
+#include <cstdlib>
+
+using namespace lib_interval_tree;
+using namespace benchmark_utility;
+
+/**
+ *  Counts the intervals overlapping wide queries, once by visiting them with overlap_find_all and once with
+ *  counting_interval_tree::overlap_count.
+ *  Usage: bench-overlap_count [intervals] [queries] [query length]
+ */
+int main(int argc, char** argv)
+{
+    const std::size_t count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+    const std::size_t query_count = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 1000;
+    const int query_length = argc > 3 ? std::atoi(argv[3]) : static_cast<int>(count);
+    const int range = static_cast<int>(count) * 10;
+
+    const auto intervals = random_intervals(count, range, 100);
+    const auto queries = random_intervals(query_count, range, query_length, 7);
+
+    interval_tree<interval_type> tree;
+    counting_interval_tree<interval_type> counting;
+    for (auto const& ival : intervals)
+    {
+        tree.insert(ival);
+        counting.insert(ival);
+    }
+
+    long long found = 0;
+    double elapsed = time_ms([&] {
+        for (auto const& query : queries)
+        {
+            tree.overlap_find_all(query, [&found](interval_tree<interval_type>::iterator) {
+                ++found;
+                return true;
+            });
+        }
+    });
+    do_not_optimize(found);
+    report("overlap_find_all counting", elapsed, queries.size(), found);
+
+    found = 0;
+    elapsed = time_ms([&] {
+        for (auto const& query : queries)
+            found += static_cast<long long>(counting.overlap_count(query));
+    });
+    do_not_optimize(found);
+    report("overlap_count", elapsed, queries.size(), found);
+    return 0;
+}
@@ -0,0 +1,82 @@
+#include "benchmark_utility.hpp"
+
+#include <interval-tree/interval_tree_parallel.hpp>
+
+#include <atomic>
+#include <cstdlib>
+
+using namespace lib_interval_tree;
+using namespace benchmark_utility;
+
+/**
+ *  Compares overlap_join of two trees with one overlap_find_all on tree b per interval of tree a,
+ *  once in the order the intervals were generated and once in the order of tree a.
+ *  Usage: bench-overlap_join [intervals in a] [intervals in b] [max length] [threads]
+ */
+int main(int argc, char** argv)
+{
+    const std::size_t count_a = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+    const std::size_t count_b = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 1000000;
+    const int max_length = argc > 3 ? std::atoi(argv[3]) : 100;
+    const unsigned threads = argc > 4 ? static_cast<unsigned>(std::strtoul(argv[4], nullptr, 10)) : 0;
+    const int range = static_cast<int>(std::max(count_a, count_b)) * 10;
+
+    const auto intervals_a = random_intervals(count_a, range, max_length, 1);
+    const auto intervals_b = random_intervals(count_b, range, max_length, 2);
+    using const_iterator = interval_tree<interval_type>::const_iterator;
+    interval_tree<interval_type> tree_a;
+    interval_tree<interval_type> tree_b;
+    tree_a.assign_unsorted(intervals_a.begin(), intervals_a.end());
+    tree_b.assign_unsorted(intervals_b.begin(), intervals_b.end());
+
+    long long pairs = 0;
+    double elapsed = time_ms([&] {
+        for (auto const& ival : intervals_a)
+        {
+            tree_b.overlap_find_all(ival, [&pairs](interval_tree<interval_type>::iterator) {
+                ++pairs;
+                return true;
+            });
+        }
+    });
+    do_not_optimize(pairs);
+    report("overlap_find_all, a unsorted", elapsed, count_a, pairs);
+
+    pairs = 0;
+    elapsed = time_ms([&] {
+        for (auto const& ival : tree_a)
+        {
+            tree_b.overlap_find_all(ival, [&pairs](interval_tree<interval_type>::iterator) {
+                ++pairs;
+                return true;
+            });
+        }
+    });
+    do_not_optimize(pairs);
+    report("overlap_find_all, a in tree order", elapsed, count_a, pairs);
+
+    pairs = 0;
+    elapsed = time_ms([&] {
+        overlap_join(tree_a, tree_b, [&pairs](const_iterator, const_iterator) {
+            ++pairs;
+            return true;
+        });
+    });
+    do_not_optimize(pairs);
+    report("overlap_join", elapsed, count_a, pairs);
+
+    std::atomic<long long> parallel_pairs{0};
+    elapsed = time_ms([&] {
+        parallel_overlap_join(
+            tree_a,
+            tree_b,
+            [&parallel_pairs](const_iterator, const_iterator) {
+                parallel_pairs.fetch_add(1, std::memory_order_relaxed);
+                return true;
+            },
+            threads
+        );
+    });
+    report("parallel_overlap_join", elapsed, count_a, parallel_pairs.load());
+    return 0;
+}
@@ -0,0 +1,82 @@
+#include "benchmark_utility.hpp"
+
+#include <cstdlib>
+
+using namespace lib_interval_tree;
+using namespace benchmark_utility;
+
+struct visit_counting_hooks : public hooks::regular
+{
+    struct hook_state
+    {
+        mutable long long visits{0};
+    };
+
+    template <typename tree_type>
+    static inline void on_overlap_find_all(
+        tree_type const& tree,
+        typename tree_type::node_type*,
+        typename tree_type::interval_type const&
+    ) noexcept
+    {
+        ++tree.visits;
+    }
+};
+
+using tree_type = interval_tree<interval_type, visit_counting_hooks>;
+
+/**
+ *  Nodes the search would visit if it only pruned by the max of subtrees.
+ */
+long long max_only_visits(tree_type::node_type const* node, interval_type const& query)
+{
+    long long visits = 1;
+    if (node->left() && node->left()->max() >= query.low())
+        visits += max_only_visits(node->left(), query);
+    if (node->right() && node->right()->max() >= query.low())
+        visits += max_only_visits(node->right(), query);
+    return visits;
+}
+
+/**
+ *  Counts the nodes visited by narrow overlap queries, with pruning by key order and by max only.
+ *  Usage: bench-overlap_pruning [interval count] [query count]
+ */
+int main(int argc, char** argv)
+{
+    const std::size_t count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+    const std::size_t queries = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 1000;
+    const int range = static_cast<int>(count) * 10;
+
+    const auto intervals = random_intervals(count, range, 100);
+    const auto query_intervals = random_intervals(queries, range, 10, 7);
+
+    tree_type tree;
+    for (auto const& ival : intervals)
+        tree.insert(ival);
+
+    long long found = 0;
+    const double elapsed = time_ms([&] {
+        for (auto const& query : query_intervals)
+        {
+            tree.overlap_find_all(query, [&found](tree_type::iterator) {
+                ++found;
+                return true;
+            });
+        }
+    });
+    do_not_optimize(found);
+    report("overlap_find_all, narrow queries", elapsed, queries, found);
+
+    long long max_only = 0;
+    for (auto const& query : query_intervals)
+        max_only += max_only_visits(tree.root().node(), query);
+
+    std::printf(
+        "nodes visited per query: %.1f (max pruning only: %.1f), results per query: %.1f\n",
+        static_cast<double>(tree.visits) / static_cast<double>(queries),
+        static_cast<double>(max_only) / static_cast<double>(queries),
+        static_cast<double>(found) / static_cast<double>(queries)
+    );
+    return 0;
+}
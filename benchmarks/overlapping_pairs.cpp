@@ -0,0 +1,49 @@
+#include "benchmark_utility.hpp"
+
+#include <cstdlib>
+
+using namespace lib_interval_tree;
+using namespace benchmark_utility;
+
+/**
+ *  Compares for_each_overlapping_pair with one overlap_find_all per interval, which sees every pair twice
+ *  and every interval with itself.
+ *  Usage: bench-overlapping_pairs [intervals] [max length]
+ */
+int main(int argc, char** argv)
+{
+    const std::size_t count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+    const int max_length = argc > 2 ? std::atoi(argv[2]) : 100;
+    const int range = static_cast<int>(count) * 10;
+
+    const auto intervals = random_intervals(count, range, max_length);
+    interval_tree<interval_type> mutable_tree;
+    mutable_tree.assign_unsorted(intervals.begin(), intervals.end());
+    auto const& tree = mutable_tree;
+    using const_iterator = interval_tree<interval_type>::const_iterator;
+
+    long long pairs = 0;
+    double elapsed = time_ms([&] {
+        for (auto const& ival : tree)
+        {
+            tree.overlap_find_all(ival, [&pairs](const_iterator) {
+                ++pairs;
+                return true;
+            });
+        }
+        pairs = (pairs - static_cast<long long>(count)) / 2;
+    });
+    do_not_optimize(pairs);
+    report("overlap_find_all per interval", elapsed, count, pairs);
+
+    pairs = 0;
+    elapsed = time_ms([&] {
+        tree.for_each_overlapping_pair([&pairs](const_iterator, const_iterator) {
+            ++pairs;
+            return true;
+        });
+    });
+    do_not_optimize(pairs);
+    report("for_each_overlapping_pair", elapsed, count, pairs);
+    return 0;
+}
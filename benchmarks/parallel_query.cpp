@@ -0,0 +1,40 @@
+#include "benchmark_utility.hpp"
+
+#include <interval-tree/interval_tree_parallel.hpp>
+
+#include <cstdlib>
+#include <vector>
+
+using namespace lib_interval_tree;
+using namespace benchmark_utility;
+
+/**
+ *  Compares a wide overlap_find_all with parallel_overlap_find_all.
+ *  Usage: bench-parallel_query [interval count] [threads]
+ */
+int main(int argc, char** argv)
+{
+    const std::size_t count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 4000000;
+    const unsigned threads = argc > 2 ? static_cast<unsigned>(std::strtoul(argv[2], nullptr, 10)) : 0;
+    const int range = static_cast<int>(count) * 10;
+
+    const auto intervals = random_intervals(count, range, 100);
+    interval_tree<interval_type> tree;
+    tree.assign_unsorted(intervals.begin(), intervals.end());
+    const interval_type query{range / 10, range - range / 10};
+
+    std::vector<interval_type> results;
+    double elapsed = time_ms([&] {
+        tree.overlap_find_all(query, [&results](interval_tree<interval_type>::iterator iter) {
+            results.push_back(*iter);
+            return true;
+        });
+    });
+    report("overlap_find_all, 80% of the tree", elapsed, results.size(), static_cast<long long>(results.size()));
+
+    elapsed = time_ms([&] {
+        parallel_overlap_find_all(tree, query, results, threads);
+    });
+    report("parallel_overlap_find_all", elapsed, results.size(), static_cast<long long>(results.size()));
+    return 0;
+}
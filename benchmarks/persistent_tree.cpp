@@ -0,0 +1,72 @@
+#include "benchmark_utility.hpp"
+
+#include <interval-tree/persistent_interval_tree.hpp>
+
+#include <cstdlib>
+
+using namespace lib_interval_tree;
+using namespace benchmark_utility;
+
+/**
+ *  Compares inserting into a persistent_interval_tree, committing every batch, with inserting into an interval_tree,
+ *  and querying a snapshot with querying the interval_tree.
+ *  Usage: bench-persistent_tree [intervals] [intervals per commit] [queries]
+ */
+int main(int argc, char** argv)
+{
+    const std::size_t count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+    const std::size_t batch = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 100;
+    const std::size_t query_count = argc > 3 ? std::strtoull(argv[3], nullptr, 10) : 1000000;
+    const int range = static_cast<int>(count) * 10;
+
+    const auto intervals = random_intervals(count, range, 100, 1);
+    const auto queries = random_intervals(query_count, range, 100, 2);
+
+    interval_tree<interval_type> tree;
+    double elapsed = time_ms([&] {
+        for (auto const& ival : intervals)
+            tree.insert(ival);
+    });
+    report("interval_tree insert", elapsed, count, static_cast<long long>(tree.size()));
+
+    persistent_interval_tree<interval_type> persistent;
+    elapsed = time_ms([&] {
+        std::size_t i = 0;
+        for (auto const& ival : intervals)
+        {
+            persistent.insert(ival);
+            if (++i % batch == 0)
+                persistent.commit();
+        }
+        persistent.commit();
+    });
+    report("persistent insert and commit", elapsed, count, static_cast<long long>(persistent.size()));
+
+    long long found = 0;
+    elapsed = time_ms([&] {
+        for (auto const& query : queries)
+        {
+            tree.overlap_find_all(query, [&found](interval_tree<interval_type>::iterator) {
+                ++found;
+                return true;
+            });
+        }
+    });
+    do_not_optimize(found);
+    report("interval_tree overlap_find_all", elapsed, query_count, found);
+
+    found = 0;
+    const auto snapshot = persistent.get_snapshot();
+    elapsed = time_ms([&] {
+        for (auto const& query : queries)
+        {
+            snapshot.overlap_find_all(query, [&found](interval_type const&) {
+                ++found;
+                return true;
+            });
+        }
+    });
+    do_not_optimize(found);
+    report("snapshot overlap_find_all", elapsed, query_count, found);
+    return 0;
+}
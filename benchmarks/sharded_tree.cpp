@@ -0,0 +1,89 @@
+#include "benchmark_utility.hpp"
+
+#include <interval-tree/sharded_interval_tree.hpp>
+
+#include <cstdlib>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace lib_interval_tree;
+using namespace benchmark_utility;
+
+/**
+ *  Inserts intervals from several threads, every thread into its own part of the value domain, once into an
+ *  interval_tree behind one mutex and once into a sharded_interval_tree with one shard per thread.
+ *  Usage: bench-sharded_tree [intervals] [threads] [max length]
+ */
+int main(int argc, char** argv)
+{
+    const std::size_t count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+    const unsigned threads = argc > 2 ? static_cast<unsigned>(std::strtoul(argv[2], nullptr, 10)) : 4;
+    const int max_length = argc > 3 ? std::atoi(argv[3]) : 100;
+    const int range = static_cast<int>(count) * 10;
+
+    auto intervals = random_intervals(count, range, max_length);
+    // Thread t inserts the intervals of the t-th part of the domain.
+    std::vector<std::vector<interval_type>> parts(threads);
+    for (auto const& ival : intervals)
+        parts[static_cast<std::size_t>(ival.low()) * threads / static_cast<std::size_t>(range)].push_back(ival);
+
+    const auto run = [&](auto const& insert) {
+        std::vector<std::thread> pool;
+        for (unsigned t = 0; t != threads; ++t)
+        {
+            pool.emplace_back([&, t] {
+                for (auto const& ival : parts[t])
+                    insert(ival);
+            });
+        }
+        for (auto& thread : pool)
+            thread.join();
+    };
+
+    interval_tree<interval_type> tree;
+    std::mutex mutex;
+    double elapsed = time_ms([&] {
+        run([&](interval_type const& ival) {
+            std::lock_guard<std::mutex> lock{mutex};
+            tree.insert(ival);
+        });
+    });
+    report("interval_tree with one mutex", elapsed, count, static_cast<long long>(tree.size()));
+
+    sharded_interval_tree<interval_type> sharded{threads, 0, range};
+    elapsed = time_ms([&] {
+        run([&](interval_type const& ival) {
+            sharded.insert(ival);
+        });
+    });
+    report("sharded_interval_tree", elapsed, count, static_cast<long long>(sharded.size()));
+
+    long long found = 0;
+    const auto queries = random_intervals(count / 10, range, max_length, 7);
+    elapsed = time_ms([&] {
+        for (auto const& query : queries)
+        {
+            tree.overlap_find_all(query, [&found](interval_tree<interval_type>::iterator) {
+                ++found;
+                return true;
+            });
+        }
+    });
+    do_not_optimize(found);
+    report("interval_tree overlap_find_all", elapsed, queries.size(), found);
+
+    found = 0;
+    elapsed = time_ms([&] {
+        for (auto const& query : queries)
+        {
+            sharded.overlap_find_all(query, [&found](interval_type const&) {
+                ++found;
+                return true;
+            });
+        }
+    });
+    do_not_optimize(found);
+    report("sharded overlap_find_all", elapsed, queries.size(), found);
+    return 0;
+}
@@ -0,0 +1,85 @@
+#include "benchmark_utility.hpp"
+
+#include <interval-tree/interval_skip_list.hpp>
+
+#include <cstdlib>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace lib_interval_tree;
+using namespace benchmark_utility;
+
+/**
+ *  Inserts intervals from several threads, once into an interval_tree behind one mutex and once into a
+ *  concurrent_interval_skip_list, then queries both from one thread.
+ *  Usage: bench-skip_list [intervals] [threads] [max length]
+ */
+int main(int argc, char** argv)
+{
+    const std::size_t count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+    const unsigned threads = argc > 2 ? static_cast<unsigned>(std::strtoul(argv[2], nullptr, 10)) : 4;
+    const int max_length = argc > 3 ? std::atoi(argv[3]) : 100;
+    const int range = static_cast<int>(count) * 10;
+
+    const auto intervals = random_intervals(count, range, max_length);
+
+    const auto run = [&](auto const& insert) {
+        std::vector<std::thread> pool;
+        for (unsigned t = 0; t != threads; ++t)
+        {
+            pool.emplace_back([&, t] {
+                for (auto i = t; i < intervals.size(); i += threads)
+                    insert(intervals[i]);
+            });
+        }
+        for (auto& thread : pool)
+            thread.join();
+    };
+
+    interval_tree<interval_type> tree;
+    std::mutex mutex;
+    double elapsed = time_ms([&] {
+        run([&](interval_type const& ival) {
+            std::lock_guard<std::mutex> lock{mutex};
+            tree.insert(ival);
+        });
+    });
+    report("interval_tree with one mutex", elapsed, count, static_cast<long long>(tree.size()));
+
+    concurrent_interval_skip_list<interval_type> list;
+    elapsed = time_ms([&] {
+        run([&](interval_type const& ival) {
+            list.insert(ival);
+        });
+    });
+    report("concurrent_interval_skip_list", elapsed, count, static_cast<long long>(list.size()));
+
+    long long found = 0;
+    const auto queries = random_intervals(count / 10, range, max_length, 7);
+    elapsed = time_ms([&] {
+        for (auto const& query : queries)
+        {
+            tree.overlap_find_all(query, [&found](interval_tree<interval_type>::iterator) {
+                ++found;
+                return true;
+            });
+        }
+    });
+    do_not_optimize(found);
+    report("interval_tree overlap_find_all", elapsed, queries.size(), found);
+
+    found = 0;
+    elapsed = time_ms([&] {
+        for (auto const& query : queries)
+        {
+            list.overlap_find_all(query, [&found](interval_type const&) {
+                ++found;
+                return true;
+            });
+        }
+    });
+    do_not_optimize(found);
+    report("skip list overlap_find_all", elapsed, queries.size(), found);
+    return 0;
+}
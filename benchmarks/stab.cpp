@@ -0,0 +1,62 @@
+#include "benchmark_utility.hpp"
+
+#include <cstdlib>
+
+using namespace lib_interval_tree;
+using namespace benchmark_utility;
+
+/**
+ *  Compares point queries through stab with overlap_find_all on a degenerate interval.
+ *  Usage: bench-stab [interval count] [query count]
+ */
+int main(int argc, char** argv)
+{
+    const std::size_t count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+    const std::size_t queries = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 1000000;
+    const int range = static_cast<int>(count) * 10;
+
+    const auto intervals = random_intervals(count, range, 100);
+    interval_tree<interval_type> tree;
+    tree.assign_unsorted(intervals.begin(), intervals.end());
+
+    std::mt19937 gen{7};
+    std::uniform_int_distribution<int> value_dist{0, range - 1};
+    std::vector<int> values(queries);
+    for (auto& value : values)
+        value = value_dist(gen);
+
+    long long found = 0;
+    double elapsed = time_ms([&] {
+        for (auto value : values)
+        {
+            tree.overlap_find_all({value, value}, [&found](interval_tree<interval_type>::iterator) {
+                ++found;
+                return true;
+            });
+        }
+    });
+    do_not_optimize(found);
+    report("overlap_find_all({v, v})", elapsed, queries, found);
+
+    found = 0;
+    elapsed = time_ms([&] {
+        for (auto value : values)
+        {
+            tree.stab(value, [&found](interval_tree<interval_type>::iterator) {
+                ++found;
+                return true;
+            });
+        }
+    });
+    do_not_optimize(found);
+    report("stab(v)", elapsed, queries, found);
+
+    found = 0;
+    elapsed = time_ms([&] {
+        for (auto value : values)
+            found += tree.stab_first(value) != tree.end() ? 1 : 0;
+    });
+    do_not_optimize(found);
+    report("stab_first(v)", elapsed, queries, found);
+    return 0;
+}
@@ -0,0 +1,63 @@
+#include "benchmark_utility.hpp"
+
+#include <interval-tree/static_interval_index.hpp>
+
+#include <cstdlib>
+
+using namespace lib_interval_tree;
+using namespace benchmark_utility;
+
+/**
+ *  Compares overlap queries on the dynamic tree with the frozen static_interval_index.
+ *  Usage: bench-static_index [interval count] [query count]
+ */
+int main(int argc, char** argv)
+{
+    const std::size_t count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+    const std::size_t queries = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 1000;
+    const int range = static_cast<int>(count) * 10;
+
+    const auto intervals = random_intervals(count, range, 100);
+    const auto query_intervals = random_intervals(queries, range, 1000, 7);
+
+    interval_tree_t<int> tree;
+    double elapsed = time_ms([&] {
+        for (auto const& ival : intervals)
+            tree.insert(ival);
+    });
+    report("build interval_tree", elapsed, count, tree.size());
+
+    static_interval_index<interval_type> index;
+    elapsed = time_ms([&] {
+        index = tree.freeze();
+    });
+    report("freeze", elapsed, count, static_cast<long long>(index.size()));
+
+    long long found = 0;
+    elapsed = time_ms([&] {
+        for (auto const& query : query_intervals)
+        {
+            tree.overlap_find_all(query, [&found](interval_tree_t<int>::iterator iter) {
+                found += iter->low();
+                return true;
+            });
+        }
+    });
+    do_not_optimize(found);
+    report("interval_tree::overlap_find_all", elapsed, queries, found);
+
+    found = 0;
+    elapsed = time_ms([&] {
+        for (auto const& query : query_intervals)
+        {
+            index.overlap_find_all(query, [&found](static_interval_index<interval_type>::const_iterator iter) {
+                found += iter->low();
+                return true;
+            });
+        }
+    });
+    do_not_optimize(found);
+    report("static_interval_index::overlap_find_all", elapsed, queries, found);
+
+    return 0;
+}
@@ -0,0 +1,79 @@
+#include "benchmark_utility.hpp"
+
+#include <interval-tree/sweep_overlap_join.hpp>
+
+#include <algorithm>
+#include <cstdlib>
+
+using namespace lib_interval_tree;
+using namespace benchmark_utility;
+
+/**
+ *  Compares sweep_overlap_join of two sorted vectors with overlap_join of two trees built from the same intervals.
+ *  Tree construction is not part of the overlap_join time.
+ *  Usage: bench-sweep_join [intervals in a] [intervals in b] [max length]
+ */
+int main(int argc, char** argv)
+{
+    const std::size_t count_a = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+    const std::size_t count_b = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 1000000;
+    const int max_length = argc > 3 ? std::atoi(argv[3]) : 100;
+    const int range = static_cast<int>(std::max(count_a, count_b)) * 10;
+
+    auto intervals_a = random_intervals(count_a, range, max_length, 1);
+    auto intervals_b = random_intervals(count_b, range, max_length, 2);
+    interval_tree<interval_type> tree_a;
+    interval_tree<interval_type> tree_b;
+    tree_a.assign_unsorted(intervals_a.begin(), intervals_a.end());
+    tree_b.assign_unsorted(intervals_b.begin(), intervals_b.end());
+
+    const auto by_low = [](interval_type const& lhs, interval_type const& rhs) {
+        return lhs.low() < rhs.low();
+    };
+    std::sort(intervals_a.begin(), intervals_a.end(), by_low);
+    std::sort(intervals_b.begin(), intervals_b.end(), by_low);
+
+    using const_iterator = interval_tree<interval_type>::const_iterator;
+    long long pairs = 0;
+    double elapsed = time_ms([&] {
+        overlap_join(tree_a, tree_b, [&pairs](const_iterator, const_iterator) {
+            ++pairs;
+            return true;
+        });
+    });
+    do_not_optimize(pairs);
+    report("overlap_join", elapsed, count_a, pairs);
+
+    pairs = 0;
+    elapsed = time_ms([&] {
+        sweep_overlap_join(
+            intervals_a.begin(),
+            intervals_a.end(),
+            intervals_b.begin(),
+            intervals_b.end(),
+            [&pairs](interval_type const&, interval_type const&) {
+                ++pairs;
+                return true;
+            }
+        );
+    });
+    do_not_optimize(pairs);
+    report("sweep_overlap_join, sorted vectors", elapsed, count_a, pairs);
+
+    pairs = 0;
+    elapsed = time_ms([&] {
+        sweep_overlap_join(
+            tree_a.begin(),
+            tree_a.end(),
+            tree_b.begin(),
+            tree_b.end(),
+            [&pairs](interval_type const&, interval_type const&) {
+                ++pairs;
+                return true;
+            }
+        );
+    });
+    do_not_optimize(pairs);
+    report("sweep_overlap_join, tree iterators", elapsed, count_a, pairs);
+    return 0;
+}
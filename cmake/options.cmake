@@ -1,4 +1,5 @@
 option(INT_TREE_DRAW_EXAMPLES "Draws some examples in a subdirectory. run make_drawable.sh before this" OFF)
 option(INT_TREE_ENABLE_TESTS "Enable tests?" OFF)
+option(INT_TREE_BUILD_BENCHMARKS "Build benchmarks?" OFF)
 # You generally do not want to turn this on, unless you are testing the library.
 option(INT_TREE_USE_OPTIONAL_POLYFILL "Use optional polyfill?" OFF)
\ No newline at end of file
@@ -0,0 +1,317 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#if defined(__linux__)
+#    include <sys/mman.h>
+#endif
+
+namespace lib_interval_tree
+{
+    // ############################################################################################################
+    struct arena_options
+    {
+        /**
+         *  Size of a single slab in bytes. Rounded up to hold at least one block.
+         */
+        std::size_t slab_bytes = 64 * 1024;
+
+        /**
+         *  Back slabs by transparent huge pages (madvise(MADV_HUGEPAGE)).
+         *  Slabs are then allocated with mmap and rounded up to the huge page size.
+         *  Ignored on platforms other than linux.
+         */
+        bool huge_pages = false;
+    };
+    // ############################################################################################################
+    /**
+     *  A single threaded fixed block size arena.
+     *  Blocks are carved out of big slabs, freed blocks go onto a free list and are reused first.
+     *  All slabs can be released at once, regardless of how many blocks are still handed out.
+     */
+    class slab_arena
+    {
+      public:
+#if defined(__linux__)
+        static constexpr std::size_t huge_page_size = 2 * 1024 * 1024;
+#endif
+
+        explicit slab_arena(arena_options const& options = {})
+            : options_{options}
+            , block_size_{0}
+            , block_align_{0}
+            , slabs_{nullptr}
+            , free_list_{nullptr}
+            , bump_{nullptr}
+            , bump_end_{nullptr}
+            , slab_count_{0}
+            , live_blocks_{0}
+        {}
+
+        ~slab_arena()
+        {
+            release();
+        }
+
+        slab_arena(slab_arena const&) = delete;
+        slab_arena& operator=(slab_arena const&) = delete;
+
+        /**
+         *  Returns whether blocks of the given geometry can be served by this arena.
+         *  The geometry of the arena is fixed by the first call to allocate.
+         */
+        bool serves(std::size_t size, std::size_t align) const noexcept
+        {
+            if (block_size_ == 0)
+                return true;
+            return size <= block_size_ && align <= block_align_;
+        }
+
+        void* allocate(std::size_t size, std::size_t align)
+        {
+            if (block_size_ == 0)
+            {
+                block_align_ = std::max(align, alignof(free_block));
+                block_size_ = round_up(std::max(size, sizeof(free_block)), block_align_);
+            }
+
+            ++live_blocks_;
+            if (free_list_)
+            {
+                auto* block = free_list_;
+                free_list_ = free_list_->next;
+                return block;
+            }
+
+            if (bump_ == bump_end_)
+                add_slab();
+
+            auto* block = bump_;
+            bump_ += block_size_;
+            return block;
+        }
+
+        void deallocate(void* block) noexcept
+        {
+            --live_blocks_;
+            auto* freed = ::new (block) free_block;
+            freed->next = free_list_;
+            free_list_ = freed;
+        }
+
+        /**
+         *  Releases all slabs at once. Every block handed out by this arena becomes invalid.
+         */
+        void release() noexcept
+        {
+            while (slabs_)
+            {
+                auto* next = slabs_->next;
+                free_slab(slabs_);
+                slabs_ = next;
+            }
+            free_list_ = nullptr;
+            bump_ = nullptr;
+            bump_end_ = nullptr;
+            slab_count_ = 0;
+            live_blocks_ = 0;
+        }
+
+        std::size_t slab_count() const noexcept
+        {
+            return slab_count_;
+        }
+
+        /**
+         *  Returns the amount of blocks that are currently handed out.
+         */
+        std::size_t live_blocks() const noexcept
+        {
+            return live_blocks_;
+        }
+
+        arena_options const& options() const noexcept
+        {
+            return options_;
+        }
+
+      private:
+        struct free_block
+        {
+            free_block* next;
+        };
+
+        struct slab_header
+        {
+            slab_header* next;
+            std::size_t bytes;
+            bool mapped;
+        };
+
+        static std::size_t round_up(std::size_t value, std::size_t alignment) noexcept
+        {
+            return (value + alignment - 1) / alignment * alignment;
+        }
+
+        void add_slab()
+        {
+            const auto header_bytes = round_up(sizeof(slab_header), block_align_);
+            auto bytes = std::max(options_.slab_bytes, header_bytes + block_size_);
+
+            void* memory = nullptr;
+            bool mapped = false;
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+            if (options_.huge_pages)
+            {
+                bytes = round_up(bytes, huge_page_size);
+                memory = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+                if (memory == MAP_FAILED)
+                    throw std::bad_alloc{};
+                // Only a hint, the kernel may not have huge pages available.
+                ::madvise(memory, bytes, MADV_HUGEPAGE);
+                mapped = true;
+            }
+#endif
+            if (!mapped)
+            {
+                // Stricter alignments than max_align_t are not needed for nodes.
+                if (block_align_ > alignof(std::max_align_t))
+                    throw std::bad_alloc{};
+                memory = ::operator new(bytes);
+            }
+
+            auto* slab = ::new (memory) slab_header{slabs_, bytes, mapped};
+            slabs_ = slab;
+            ++slab_count_;
+
+            auto* begin = static_cast<unsigned char*>(memory) + header_bytes;
+            const auto blocks = (bytes - header_bytes) / block_size_;
+            bump_ = begin;
+            bump_end_ = begin + blocks * block_size_;
+        }
+
+        static void free_slab(slab_header* slab) noexcept
+        {
+#if defined(__linux__)
+            if (slab->mapped)
+            {
+                ::munmap(slab, slab->bytes);
+                return;
+            }
+#endif
+            ::operator delete(slab);
+        }
+
+      private:
+        arena_options options_;
+        std::size_t block_size_;
+        std::size_t block_align_;
+        slab_header* slabs_;
+        free_block* free_list_;
+        unsigned char* bump_;
+        unsigned char* bump_end_;
+        std::size_t slab_count_;
+        std::size_t live_blocks_;
+    };
+    // ############################################################################################################
+    /**
+     *  Allocator that serves single object allocations from a slab_arena.
+     *  Copies share the arena, copy construction of a container creates a fresh arena.
+     *  Containers that detect release_all() (like interval_tree) can drop all their nodes at once,
+     *  as long as they are the only owner of the arena.
+     *
+     *  Not thread safe, each tree should have its own arena.
+     */
+    template <typename T>
+    class arena_allocator
+    {
+      public:
+        using value_type = T;
+        using propagate_on_container_copy_assignment = std::false_type;
+        using propagate_on_container_move_assignment = std::true_type;
+        using propagate_on_container_swap = std::true_type;
+        using is_always_equal = std::false_type;
+
+        template <typename U>
+        friend class arena_allocator;
+
+        template <typename U>
+        struct rebind
+        {
+            using other = arena_allocator<U>;
+        };
+
+        explicit arena_allocator(arena_options const& options = {})
+            : arena_{std::make_shared<slab_arena>(options)}
+        {}
+
+        template <typename U>
+        arena_allocator(arena_allocator<U> const& other) noexcept
+            : arena_{other.arena_}
+        {}
+
+        T* allocate(std::size_t n)
+        {
+            if (n == 1 && arena_->serves(sizeof(T), alignof(T)))
+                return static_cast<T*>(arena_->allocate(sizeof(T), alignof(T)));
+            return std::allocator<T>{}.allocate(n);
+        }
+
+        void deallocate(T* p, std::size_t n) noexcept
+        {
+            if (n == 1 && arena_->serves(sizeof(T), alignof(T)))
+                arena_->deallocate(p);
+            else
+                std::allocator<T>{}.deallocate(p, n);
+        }
+
+        /**
+         *  Copies of a container get their own arena with the same options.
+         */
+        arena_allocator select_on_container_copy_construction() const
+        {
+            return arena_allocator{arena_->options()};
+        }
+
+        /**
+         *  Returns whether release_all can be called without invalidating memory of anyone else.
+         */
+        bool can_release_all() const noexcept
+        {
+            return arena_.use_count() == 1;
+        }
+
+        /**
+         *  Frees every block of the arena at once. Destructors are not called.
+         */
+        void release_all() noexcept
+        {
+            arena_->release();
+        }
+
+        slab_arena const& arena() const noexcept
+        {
+            return *arena_;
+        }
+
+        template <typename U>
+        friend bool operator==(arena_allocator const& lhs, arena_allocator<U> const& rhs) noexcept
+        {
+            return &lhs.arena() == &rhs.arena();
+        }
+
+        template <typename U>
+        friend bool operator!=(arena_allocator const& lhs, arena_allocator<U> const& rhs) noexcept
+        {
+            return &lhs.arena() != &rhs.arena();
+        }
+
+      private:
+        std::shared_ptr<slab_arena> arena_;
+    };
+}
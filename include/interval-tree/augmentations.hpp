@@ -0,0 +1,202 @@
+#pragma once
+
+#include "interval_types.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <type_traits>
+
+namespace lib_interval_tree
+{
+    /**
+     *  Ready made augmentations for hooks::with_augmentation.
+     */
+    namespace augmentations
+    {
+        /**
+         *  The amount of intervals.
+         */
+        template <typename size_type = std::size_t>
+        struct count
+        {
+            using value_type = size_type;
+
+            static value_type identity() noexcept
+            {
+                return 0;
+            }
+
+            template <typename interval_type>
+            static value_type from_interval(interval_type const&) noexcept
+            {
+                return 1;
+            }
+
+            static value_type combine(value_type const& left, value_type const& right) noexcept
+            {
+                return left + right;
+            }
+        };
+
+        /**
+         *  The sum of interval::size() of all intervals, overlapping parts count several times.
+         */
+        template <typename numerical_type>
+        struct total_size
+        {
+            using value_type = numerical_type;
+
+            static value_type identity() noexcept
+            {
+                return 0;
+            }
+
+            template <typename interval_type>
+            static value_type from_interval(interval_type const& ival)
+            {
+                return ival.size();
+            }
+
+            static value_type combine(value_type const& left, value_type const& right) noexcept
+            {
+                return left + right;
+            }
+        };
+
+        /**
+         *  The smallest high of all intervals. With the max of the tree this bounds the highs of a subtree.
+         */
+        template <typename numerical_type>
+        struct min_high
+        {
+            using value_type = numerical_type;
+
+            static value_type identity() noexcept
+            {
+                return std::numeric_limits<value_type>::max();
+            }
+
+            template <typename interval_type>
+            static value_type from_interval(interval_type const& ival)
+            {
+                return ival.high();
+            }
+
+            static value_type combine(value_type const& left, value_type const& right) noexcept
+            {
+                return right < left ? right : left;
+            }
+        };
+
+        /**
+         *  The length of the union of all intervals, for interval_tree::covered_length.
+         *
+         *  Every interval counts as a half open span [begin, end) that is as long as interval::size(), so integral
+         *  intervals that exclude their low start one later. The spans of a subtree come in ascending order of begin,
+         *  which makes the union of those before a span contiguous from its begin on.
+         *
+         *  This is not a monoid, the union of two subtrees depends on more than their aggregates. So it refreshes a
+         *  node from its children with from_node, which takes one way down the right subtree to find how much of
+         *  it lies past the left part. Refreshing a node takes O(log n), inserting and erasing O(log^2 n).
+         */
+        template <typename numerical_type>
+        struct union_measure
+        {
+            struct value_type
+            {
+                // The smallest begin and largest end of all spans.
+                numerical_type begin;
+                numerical_type end;
+                // The length of the union of all spans.
+                numerical_type measure;
+            };
+
+            template <typename interval_type>
+            static value_type from_interval(interval_type const& ival)
+            {
+                static_assert(
+                    !std::is_same<typename interval_type::interval_kind, dynamic>::value,
+                    "The borders of dynamic intervals differ, so their spans do not come in order of low."
+                );
+                const numerical_type begin = std::is_integral<numerical_type>::value && !ival.within(ival.low())
+                    ? static_cast<numerical_type>(ival.low() + 1)
+                    : ival.low();
+                const numerical_type size = ival.size();
+                const numerical_type end = size > 0 ? static_cast<numerical_type>(begin + size) : begin;
+                return {begin, end, static_cast<numerical_type>(end - begin)};
+            }
+
+            template <typename node_type>
+            static value_type from_node(node_type const& node)
+            {
+                auto const* left = node.left();
+                auto const* right = node.right();
+                const auto self = from_interval(*node.interval());
+
+                auto result = left ? left->aggregate() : value_type{self.begin, self.begin, 0};
+                // What the left subtree covers past self.begin is [self.begin, result.end).
+                const auto uncovered = std::max(self.begin, result.end);
+                if (uncovered < self.end)
+                    result.measure += self.end - uncovered;
+                result.end = std::max(result.end, self.end);
+                if (right)
+                {
+                    result.measure += covered_from(right, result.end);
+                    result.end = std::max(result.end, right->aggregate().end);
+                }
+                return result;
+            }
+
+            /**
+             *  The length of the union of all spans in the subtree of node within [from, to).
+             */
+            template <typename node_type>
+            static numerical_type covered(node_type const* node, numerical_type from, numerical_type to)
+            {
+                if (!(from < to))
+                    return 0;
+                return covered_from(node, from) - covered_from(node, to);
+            }
+
+            /**
+             *  The length of the union of all spans in the subtree of node from value on. Takes one way down.
+             */
+            template <typename node_type>
+            static numerical_type covered_from(node_type const* node, numerical_type value)
+            {
+                numerical_type result = 0;
+                while (node)
+                {
+                    auto const& aggregate = node->aggregate();
+                    if (!(value < aggregate.end))
+                        break;
+                    if (!(aggregate.begin < value))
+                        return result + aggregate.measure;
+
+                    auto const* left = node->left();
+                    const auto self = from_interval(*node->interval());
+                    if (!(self.begin < value))
+                    {
+                        // This span and the right subtree lie past value, so what they add to the left subtree
+                        // counts in full.
+                        result += aggregate.measure - (left ? left->aggregate().measure : 0);
+                        node = left;
+                    }
+                    else
+                    {
+                        // All spans up to this one begin before value, so they cover [value, reach) without gaps.
+                        const auto reach = left ? std::max(left->aggregate().end, self.end) : self.end;
+                        if (value < reach)
+                        {
+                            result += reach - value;
+                            value = reach;
+                        }
+                        node = node->right();
+                    }
+                }
+                return result;
+            }
+        };
+    }
+}
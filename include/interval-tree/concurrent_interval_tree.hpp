@@ -0,0 +1,340 @@
+#pragma once
+
+#include "interval_tree.hpp"
+#include "shared_mutex.hpp"
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <utility>
+#include <vector>
+
+namespace lib_interval_tree
+{
+    // ############################################################################################################
+    /**
+     *  An interval_tree behind a reader writer lock, where writers commit in groups.
+     *
+     *  Writers put their inserts and erases into a queue. The first writer that finds nobody applying the queue
+     *  becomes the combiner: it takes the whole queue, applies it under one exclusive lock and wakes the writers
+     *  whose operations are done. Writers that arrive meanwhile queue up behind it, so under load every exclusive
+     *  lock covers many operations instead of one. Runs of inserts go through insert_bulk.
+     *
+     *  Operations are applied in the order they were queued. A combiner hands over once its own operations are
+     *  done and other writers are waiting, so no writer applies the work of others for long.
+     *
+     *  Readers share the lock with each other and see everything that was applied before they took it.
+     */
+    template <typename IntervalT, typename tree_hooks = hooks::regular, typename Allocator = std::allocator<IntervalT>>
+    class concurrent_interval_tree
+    {
+      public:
+        using tree_type = interval_tree<IntervalT, tree_hooks, Allocator>;
+        using interval_type = IntervalT;
+        using value_type = typename interval_type::value_type;
+        using size_type = typename tree_type::size_type;
+
+      public:
+        explicit concurrent_interval_tree(tree_type tree = tree_type{})
+            : tree_mutex_{}
+            , tree_{std::move(tree)}
+            , queue_mutex_{}
+            , applied_signal_{}
+            , queue_{}
+            , queued_{0}
+            , applied_{0}
+            , last_waited_{0}
+            , combining_{false}
+            , async_error_{}
+        {}
+
+        concurrent_interval_tree(concurrent_interval_tree const&) = delete;
+        concurrent_interval_tree& operator=(concurrent_interval_tree const&) = delete;
+
+        ~concurrent_interval_tree()
+        {
+            std::unique_lock<std::mutex> lock{queue_mutex_};
+            applied_signal_.wait(lock, [this] {
+                return !combining_;
+            });
+        }
+
+        /**
+         *  Inserts ival and returns once it is in the tree.
+         */
+        void insert(interval_type const& ival)
+        {
+            completion done;
+            submit({operation_kind::insert, ival, &done}, true);
+            if (done.error)
+                std::rethrow_exception(done.error);
+        }
+
+        /**
+         *  Queues an insert of ival and returns without waiting for it, unless this thread has to apply the queue.
+         *  Use flush to wait for it. Errors are rethrown by the next flush.
+         */
+        void insert_async(interval_type const& ival)
+        {
+            submit({operation_kind::insert, ival, nullptr}, false);
+        }
+
+        /**
+         *  Erases one interval equal to ival and returns once it is gone.
+         *
+         *  @return Whether an interval was erased.
+         */
+        bool erase(interval_type const& ival)
+        {
+            completion done;
+            submit({operation_kind::erase, ival, &done}, true);
+            if (done.error)
+                std::rethrow_exception(done.error);
+            return done.erased;
+        }
+
+        /**
+         *  Queues an erase of ival and returns without waiting for it, see insert_async.
+         */
+        void erase_async(interval_type const& ival)
+        {
+            submit({operation_kind::erase, ival, nullptr}, false);
+        }
+
+        /**
+         *  Waits until every operation that was queued before is applied.
+         *  Rethrows the first error of an asynchronous operation since the last flush.
+         */
+        void flush()
+        {
+            std::unique_lock<std::mutex> lock{queue_mutex_};
+            wait_for(lock, queued_);
+            if (async_error_)
+            {
+                auto error = std::move(async_error_);
+                async_error_ = nullptr;
+                std::rethrow_exception(error);
+            }
+        }
+
+        /**
+         *  Calls function(tree_type const&) under a shared lock and returns its result.
+         *  function must not call any member of this, that could deadlock.
+         */
+        template <typename FunctionT>
+        auto read(FunctionT const& function) const -> decltype(function(std::declval<tree_type const&>()))
+        {
+            std::shared_lock<detail::shared_mutex> lock{tree_mutex_};
+            return function(static_cast<tree_type const&>(tree_));
+        }
+
+        /**
+         *  overlap_find_all on the tree under a shared lock, on_find gets const iterators.
+         */
+        template <typename FunctionT>
+        void overlap_find_all(interval_type const& ival, FunctionT const& on_find, bool exclusive = false) const
+        {
+            read([&](tree_type const& tree) {
+                tree.overlap_find_all(ival, on_find, exclusive);
+            });
+        }
+
+        /**
+         *  The amount of intervals in the tree, without operations that are still queued.
+         */
+        size_type size() const
+        {
+            return read([](tree_type const& tree) {
+                return tree.size();
+            });
+        }
+
+        bool empty() const
+        {
+            return size() == 0;
+        }
+
+      private:
+        enum class operation_kind
+        {
+            insert,
+            erase
+        };
+
+        /**
+         *  Lives on the stack of a writer that waits for its operation.
+         */
+        struct completion
+        {
+            bool erased = false;
+            std::exception_ptr error;
+        };
+
+        struct operation
+        {
+            operation_kind kind;
+            interval_type ival;
+            completion* done;
+        };
+
+        void submit(operation const& op, bool wait)
+        {
+            std::unique_lock<std::mutex> lock{queue_mutex_};
+            queue_.push_back(op);
+            const auto ticket = ++queued_;
+            if (wait)
+            {
+                wait_for(lock, ticket);
+            }
+            else if (!combining_)
+            {
+                combining_ = true;
+                combine(lock, ticket);
+            }
+        }
+
+        /**
+         *  Waits until the operation with the given ticket and all before it are applied.
+         *  Becomes the combiner if nobody else applies the queue.
+         */
+        void wait_for(std::unique_lock<std::mutex>& lock, std::uint64_t ticket)
+        {
+            last_waited_ = std::max(last_waited_, ticket);
+            while (applied_ < ticket)
+            {
+                if (!combining_)
+                {
+                    combining_ = true;
+                    combine(lock, ticket);
+                }
+                else
+                {
+                    applied_signal_.wait(lock);
+                }
+            }
+        }
+
+        /**
+         *  Applies the queue in batches until it is empty. Once ticket is applied, the combiner hands over to a
+         *  writer that still waits for its operation, if there is one. That writer is woken and takes over.
+         */
+        void combine(std::unique_lock<std::mutex>& lock, std::uint64_t ticket)
+        {
+            // Whatever happens, the next writer has to be able to take over.
+            struct handover
+            {
+                concurrent_interval_tree& self;
+                std::unique_lock<std::mutex>& lock;
+
+                ~handover()
+                {
+                    if (!lock.owns_lock())
+                        lock.lock();
+                    self.combining_ = false;
+                    self.applied_signal_.notify_all();
+                }
+            } done_combining{*this, lock};
+
+            std::vector<operation> batch;
+            while (!queue_.empty() && (applied_ < ticket || last_waited_ <= applied_))
+            {
+                batch.swap(queue_);
+                lock.unlock();
+                std::exception_ptr async_error;
+                try
+                {
+                    std::unique_lock<detail::shared_mutex> tree_lock{tree_mutex_};
+                    apply(batch, async_error);
+                }
+                catch (...)
+                {
+                    // Failed outside of a single operation, for example while collecting inserts.
+                    const auto error = std::current_exception();
+                    for (auto const& op : batch)
+                        fail(op, error, async_error);
+                }
+                lock.lock();
+                if (async_error && !async_error_)
+                    async_error_ = std::move(async_error);
+                applied_ += batch.size();
+                batch.clear();
+                applied_signal_.notify_all();
+            }
+        }
+
+        /**
+         *  Hands error to the writer that waits for op, or keeps it for the next flush if nobody waits.
+         */
+        static void fail(operation const& op, std::exception_ptr const& error, std::exception_ptr& async_error)
+        {
+            if (op.done != nullptr)
+                op.done->error = error;
+            else if (!async_error)
+                async_error = error;
+        }
+
+        /**
+         *  Applies a batch in order. Consecutive inserts are inserted together with insert_bulk.
+         */
+        void apply(std::vector<operation> const& batch, std::exception_ptr& async_error)
+        {
+            std::vector<interval_type> inserts;
+            for (std::size_t i = 0; i != batch.size();)
+            {
+                if (batch[i].kind == operation_kind::insert)
+                {
+                    auto last = i;
+                    inserts.clear();
+                    for (; last != batch.size() && batch[last].kind == operation_kind::insert; ++last)
+                        inserts.push_back(batch[last].ival);
+                    try
+                    {
+                        tree_.insert_bulk(inserts.begin(), inserts.end());
+                    }
+                    catch (...)
+                    {
+                        const auto error = std::current_exception();
+                        for (auto j = i; j != last; ++j)
+                            fail(batch[j], error, async_error);
+                    }
+                    i = last;
+                    continue;
+                }
+
+                try
+                {
+                    const auto iter = tree_.find(batch[i].ival);
+                    const bool found = iter != tree_.end();
+                    if (found)
+                        tree_.erase(iter);
+                    if (batch[i].done != nullptr)
+                        batch[i].done->erased = found;
+                }
+                catch (...)
+                {
+                    fail(batch[i], std::current_exception(), async_error);
+                }
+                ++i;
+            }
+        }
+
+      private:
+        mutable detail::shared_mutex tree_mutex_;
+        tree_type tree_;
+
+        std::mutex queue_mutex_;
+        std::condition_variable applied_signal_;
+        std::vector<operation> queue_;
+        std::uint64_t queued_;
+        std::uint64_t applied_;
+        /// The highest ticket a writer waits for. While it is not applied, that writer will take over combining.
+        std::uint64_t last_waited_;
+        bool combining_;
+        std::exception_ptr async_error_;
+    };
+}
@@ -0,0 +1,209 @@
+#pragma once
+
+#include "interval_tree.hpp"
+
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+namespace lib_interval_tree
+{
+    namespace detail
+    {
+        // Whether overlap_bounds tell exactly if an interval overlaps, not just whether it might.
+        // That is the case if overlapping only depends on one border of either interval at a time.
+        template <typename interval_type>
+        struct has_exact_overlap_bounds : std::false_type
+        {};
+
+        template <typename numerical_type>
+        struct has_exact_overlap_bounds<interval<numerical_type, closed>> : std::true_type
+        {};
+
+        template <typename numerical_type>
+        struct has_exact_overlap_bounds<interval<numerical_type, open>> : std::true_type
+        {};
+
+        template <typename numerical_type>
+        struct has_exact_overlap_bounds<interval<numerical_type, left_open>> : std::true_type
+        {};
+
+        template <typename numerical_type>
+        struct has_exact_overlap_bounds<interval<numerical_type, right_open>> : std::true_type
+        {};
+
+        template <typename numerical_type>
+        struct has_exact_overlap_bounds<interval<numerical_type, closed_adjacent>> : std::true_type
+        {};
+    }
+    // ############################################################################################################
+    /**
+     *  An interval_tree that counts the intervals overlapping a query in O(log n), without visiting them.
+     *
+     *  An interval does not overlap a query if its low lies past the high of the query, or its high lies before the
+     *  low of the query. The tree is ordered by low and keeps subtree sizes, so the former are a suffix that is
+     *  counted on one way down. A second tree keeps the highs, ordered as well and with subtree sizes, for the
+     *  latter. Both ways honor the borders of the interval kind.
+     *
+     *  Queries that do not count go to tree(). Changes go through this, so both trees stay in step.
+     */
+    template <typename IntervalT, typename Allocator = std::allocator<IntervalT>>
+    class counting_interval_tree
+    {
+      public:
+        using interval_type = IntervalT;
+        using value_type = typename interval_type::value_type;
+        using allocator_type = Allocator;
+        using size_type = std::size_t;
+        using tree_type =
+            interval_tree<interval_type, hooks::with_augmentation<augmentations::count<size_type>>, allocator_type>;
+        using high_interval_type = interval<value_type, closed>;
+        using high_index_type = interval_tree<
+            high_interval_type,
+            hooks::with_augmentation<augmentations::count<size_type>>,
+            typename std::allocator_traits<allocator_type>::template rebind_alloc<high_interval_type>>;
+
+        static_assert(
+            detail::has_exact_overlap_bounds<interval_type>::value,
+            "Overlaps can only be counted for intervals of a fixed kind, see interval_types.hpp."
+        );
+
+      public:
+        counting_interval_tree() = default;
+
+        explicit counting_interval_tree(allocator_type const& allocator)
+            : tree_{allocator}
+            , highs_{typename high_index_type::allocator_type{allocator}}
+        {}
+
+        /**
+         *  Inserts ival.
+         */
+        void insert(interval_type const& ival)
+        {
+            auto iter = tree_.insert(ival);
+            try
+            {
+                highs_.insert({ival.high(), ival.high()});
+            }
+            catch (...)
+            {
+                tree_.erase(iter);
+                throw;
+            }
+        }
+
+        /**
+         *  Erases one interval equal to ival.
+         *
+         *  @return Whether an interval was erased.
+         */
+        bool erase(interval_type const& ival)
+        {
+            auto iter = tree_.find(ival);
+            if (iter == tree_.end())
+                return false;
+            tree_.erase(iter);
+            highs_.erase(highs_.find({ival.high(), ival.high()}));
+            return true;
+        }
+
+        void clear()
+        {
+            tree_.clear();
+            highs_.clear();
+        }
+
+        /**
+         *  Counts the intervals that overlap ival, in O(log n).
+         *
+         *  @param exclusive Count like overlaps_exclusive instead of overlaps.
+         */
+        size_type overlap_count(interval_type const& ival, bool exclusive = false) const
+        {
+            if (exclusive)
+                return overlap_count_impl<detail::border_overlap_bounds<true, true>>(ival);
+            return overlap_count_impl<detail::overlap_bounds<interval_type>>(ival);
+        }
+
+        /**
+         *  The tree with all intervals, for queries other than counting.
+         */
+        tree_type const& tree() const noexcept
+        {
+            return tree_;
+        }
+
+        size_type size() const noexcept
+        {
+            return tree_.size();
+        }
+
+        bool empty() const noexcept
+        {
+            return tree_.empty();
+        }
+
+        allocator_type get_allocator() const
+        {
+            return tree_.get_allocator();
+        }
+
+      private:
+        template <typename bounds>
+        size_type overlap_count_impl(interval_type const& ival) const
+        {
+            size_type missed = 0;
+
+            // Lows that do not reach the high of ival are a suffix in order of low.
+            for (auto const* node = tree_.root().node(); node;)
+            {
+                if (bounds::low_reaches(node->low(), ival))
+                {
+                    node = node->right();
+                }
+                else
+                {
+                    missed += 1 + size_of(node->right());
+                    node = node->left();
+                }
+            }
+
+            // Highs that do not reach the low of ival are a prefix in order of high.
+            for (auto const* node = highs_.root().node(); node;)
+            {
+                if (bounds::high_reaches(node->low(), ival))
+                {
+                    node = node->left();
+                }
+                else
+                {
+                    missed += 1 + size_of(node->left());
+                    node = node->right();
+                }
+            }
+
+            // With strict borders, a point interval can miss a point query on both sides and was counted twice.
+            if (ival.low() == ival.high() && !bounds::low_reaches(ival.low(), ival) &&
+                !bounds::high_reaches(ival.low(), ival))
+            {
+                tree_.find_all(ival, [&missed](typename tree_type::const_iterator) {
+                    --missed;
+                    return true;
+                });
+            }
+            return tree_.size() - missed;
+        }
+
+        template <typename node_type>
+        static size_type size_of(node_type const* node) noexcept
+        {
+            return node ? node->aggregate() : 0;
+        }
+
+      private:
+        tree_type tree_;
+        high_index_type highs_;
+    };
+}
@@ -0,0 +1,128 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <limits>
+
+namespace lib_interval_tree
+{
+    namespace detail
+    {
+        // ############################################################################################################
+        /**
+         *  Epoch based reclamation for one writer and any amount of readers.
+         *
+         *  A reader pins the current epoch before it loads a shared pointer and unpins when it is done.
+         *  The writer publishes a new version, advances the epoch and tags everything the old version alone
+         *  referenced with the new epoch. Such memory can be freed once every pinned epoch is at least that tag,
+         *  because a reader that pinned the new epoch loaded the shared pointer after it was published.
+         *
+         *  Reader records are kept in a list that only grows and are reused, so pinning allocates only when
+         *  more readers than ever before are active at the same time.
+         */
+        class epoch_domain
+        {
+          public:
+            struct reader_record
+            {
+                /// The pinned epoch, 0 if the record does not pin anything.
+                std::atomic<std::uint64_t> epoch{0};
+                std::atomic<bool> in_use{false};
+                reader_record* next = nullptr;
+            };
+
+            epoch_domain() = default;
+            epoch_domain(epoch_domain const&) = delete;
+            epoch_domain& operator=(epoch_domain const&) = delete;
+
+            ~epoch_domain()
+            {
+                auto* record = head_.load();
+                while (record != nullptr)
+                {
+                    auto* next = record->next;
+                    delete record;
+                    record = next;
+                }
+            }
+
+            /**
+             *  Pins the current epoch. Shared pointers have to be loaded after this returns.
+             *  Can be called from any thread.
+             */
+            reader_record* pin()
+            {
+                auto* record = acquire_record();
+                record->epoch.store(epoch_.load());
+                return record;
+            }
+
+            /**
+             *  Pins the epoch of a record that is still pinned, for a second reader of the same version.
+             */
+            reader_record* pin_same(reader_record const* pinned)
+            {
+                auto* record = acquire_record();
+                record->epoch.store(pinned->epoch.load());
+                return record;
+            }
+
+            static void unpin(reader_record* record) noexcept
+            {
+                record->epoch.store(0);
+                record->in_use.store(false);
+            }
+
+            /**
+             *  Starts a new epoch and returns it. Only called by the writer, after publishing.
+             */
+            std::uint64_t advance() noexcept
+            {
+                return epoch_.fetch_add(1) + 1;
+            }
+
+            /**
+             *  Returns the oldest epoch that a reader still pins, or the max of uint64_t if there is none.
+             *  Memory tagged with an epoch up to this one can be freed.
+             */
+            std::uint64_t oldest_pinned() const noexcept
+            {
+                auto oldest = std::numeric_limits<std::uint64_t>::max();
+                for (auto* record = head_.load(); record != nullptr; record = record->next)
+                {
+                    const auto epoch = record->epoch.load();
+                    if (epoch != 0)
+                        oldest = std::min(oldest, epoch);
+                }
+                return oldest;
+            }
+
+          private:
+            reader_record* acquire_record()
+            {
+                for (auto* record = head_.load(); record != nullptr; record = record->next)
+                {
+                    bool expected = false;
+                    if (!record->in_use.load(std::memory_order_relaxed) &&
+                        record->in_use.compare_exchange_strong(expected, true))
+                    {
+                        return record;
+                    }
+                }
+
+                auto* record = new reader_record;
+                record->in_use.store(true, std::memory_order_relaxed);
+                record->next = head_.load();
+                while (!head_.compare_exchange_weak(record->next, record))
+                {
+                }
+                return record;
+            }
+
+          private:
+            std::atomic<std::uint64_t> epoch_{1};
+            std::atomic<reader_record*> head_{nullptr};
+        };
+    }
+}
@@ -0,0 +1,450 @@
+#pragma once
+
+#include "interval_tree.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <type_traits>
+
+namespace lib_interval_tree
+{
+    namespace detail
+    {
+        /**
+         *  A random tower height in [1, max_height], every level is 4 times less likely than the one below.
+         *  Every thread draws from its own xorshift state, so inserting threads do not share a generator.
+         */
+        inline int random_skip_height(int max_height) noexcept
+        {
+            static std::atomic<std::uint32_t> seeds{0x9e3779b9u};
+            thread_local std::uint32_t state = seeds.fetch_add(0x9e3779b9u) | 1u;
+            state ^= state << 13;
+            state ^= state >> 17;
+            state ^= state << 5;
+            int height = 1;
+            for (auto bits = state; height < max_height && (bits & 3u) == 0; bits >>= 2)
+                ++height;
+            return height;
+        }
+
+        /**
+         *  Raises value to at least candidate.
+         */
+        template <typename value_type>
+        void atomic_raise(std::atomic<value_type>& value, value_type const& candidate) noexcept
+        {
+            auto current = value.load();
+            while (current < candidate && !value.compare_exchange_weak(current, candidate))
+            {
+            }
+        }
+    }
+    // ############################################################################################################
+    /**
+     *  A lock-free skip list of intervals ordered by low, for many threads that insert and query at the same time.
+     *
+     *  Every level of a tower keeps the max high of its segment, the tower itself and the towers up to the next
+     *  tower of that level. Queries skip segments whose max does not reach the query, like overlap_find_all of
+     *  interval_tree skips subtrees. Inserts link their tower bottom up with compare and swap. Once it is in the
+     *  bottom level, an interval raises the max of the segment it falls into on every level above its tower.
+     *
+     *  A tower that is linked on a level splits a segment, its own part has no max yet. It is computed from the
+     *  bottom level after linking, and only then do queries trust it, before that they look into the segment.
+     *  An interval that is linked after that computation passed it raises the max of the new tower itself.
+     *
+     *  Intervals cannot be erased: a lock-free erase would have to keep nodes alive while queries may still walk
+     *  over them. All intervals are freed with the list. All members but the destructor are thread safe.
+     *  The value_type of the interval has to be usable in std::atomic.
+     */
+    template <typename IntervalT, typename Allocator = std::allocator<IntervalT>>
+    class concurrent_interval_skip_list
+    {
+      public:
+        using interval_type = IntervalT;
+        using value_type = typename interval_type::value_type;
+        using allocator_type = Allocator;
+        using size_type = std::size_t;
+
+        /// With 4 times fewer towers per level, this is enough for 4^16 intervals.
+        static constexpr int max_height = 16;
+
+        static_assert(
+            std::is_trivially_copyable<value_type>::value,
+            "concurrent_interval_skip_list keeps the max high of every segment in a std::atomic<value_type>."
+        );
+
+      private:
+        struct node_type;
+
+        struct skip_level
+        {
+            std::atomic<node_type*> next{nullptr};
+            /// The max high of the segment, valid once summarized is set.
+            std::atomic<value_type> max;
+            std::atomic<bool> summarized;
+
+            skip_level(value_type const& max_high, bool is_summarized) noexcept
+                : max{max_high}
+                , summarized{is_summarized}
+            {}
+        };
+
+        struct node_type
+        {
+            node_type(interval_type const& ival, int tower_height, skip_level* tower_levels)
+                : interval{ival}
+                , height{tower_height}
+                , levels{tower_levels}
+            {}
+
+            interval_type interval;
+            int height;
+            skip_level* levels;
+        };
+
+        using level_allocator_type = typename std::allocator_traits<allocator_type>::template rebind_alloc<skip_level>;
+        using level_allocator_traits = std::allocator_traits<level_allocator_type>;
+        using bounds = detail::overlap_bounds<interval_type>;
+
+        /// A node and its tower share one block of levels, the node takes the first ones.
+        static constexpr std::size_t node_slots = (sizeof(node_type) + sizeof(skip_level) - 1) / sizeof(skip_level);
+        static_assert(alignof(node_type) <= alignof(skip_level), "A node has to fit at the start of a tower block.");
+
+      public:
+        explicit concurrent_interval_skip_list(allocator_type const& alloc = allocator_type{})
+            : alloc_{alloc}
+            , level_alloc_{alloc}
+            , head_levels_{}
+            , size_{0}
+        {
+            head_levels_ = level_allocator_traits::allocate(level_alloc_, max_height);
+            // The head holds no interval, its segments are summarized from the start.
+            for (int level = 0; level != max_height; ++level)
+            {
+                level_allocator_traits::construct(
+                    level_alloc_, head_levels_ + level, std::numeric_limits<value_type>::lowest(), true
+                );
+            }
+        }
+
+        concurrent_interval_skip_list(concurrent_interval_skip_list const&) = delete;
+        concurrent_interval_skip_list& operator=(concurrent_interval_skip_list const&) = delete;
+
+        ~concurrent_interval_skip_list()
+        {
+            auto* node = head_levels_[0].next.load();
+            while (node != nullptr)
+            {
+                auto* next = node->levels[0].next.load();
+                destroy_node(node);
+                node = next;
+            }
+            destroy_levels(head_levels_, max_height);
+            level_allocator_traits::deallocate(level_alloc_, head_levels_, max_height);
+        }
+
+        void insert(interval_type const& ival)
+        {
+            const int height = detail::random_skip_height(max_height);
+            node_type* inserted = create_node(ival, height);
+            skip_level* preds[max_height];
+            node_type* succs[max_height];
+            find_position(inserted, preds, succs);
+            for (int level = 0; level != height; ++level)
+            {
+                auto& link = inserted->levels[level];
+                while (true)
+                {
+                    link.next.store(succs[level]);
+                    auto* expected = succs[level];
+                    if (preds[level][level].next.compare_exchange_strong(expected, inserted))
+                        break;
+                    find_position(inserted, preds, succs);
+                }
+                if (level == 0)
+                    raise_segments(inserted, preds);
+                else
+                    summarize(inserted, level);
+            }
+            ++size_;
+        }
+
+        /**
+         *  Calls on_find for every interval that overlaps ival, in ascending order of low.
+         *  Intervals that are inserted while the query runs may or may not be reported.
+         *
+         *  @param on_find A function of type bool(interval_type const&). Return false to stop.
+         *  @param exclusive Exclude edges?
+         */
+        template <typename FunctionT>
+        void overlap_find_all(interval_type const& ival, FunctionT const& on_find, bool exclusive = false) const
+        {
+            const auto segment_reaches = [&ival](value_type const& max) {
+                return bounds::high_reaches(max, ival);
+            };
+            const auto low_reaches = [&ival](value_type const& low) {
+                return bounds::low_reaches(low, ival);
+            };
+            if (exclusive)
+            {
+                visit(
+                    head_levels_,
+                    nullptr,
+                    max_height - 1,
+                    nullptr,
+                    segment_reaches,
+                    low_reaches,
+                    [&ival](interval_type const& candidate) {
+                        return candidate.overlaps_exclusive(ival);
+                    },
+                    on_find
+                );
+            }
+            else
+            {
+                visit(
+                    head_levels_,
+                    nullptr,
+                    max_height - 1,
+                    nullptr,
+                    segment_reaches,
+                    low_reaches,
+                    [&ival](interval_type const& candidate) {
+                        return candidate.overlaps(ival);
+                    },
+                    on_find
+                );
+            }
+        }
+
+        /**
+         *  Calls on_find for every interval that contains value, as decided by interval_type::within.
+         *
+         *  @param on_find A function of type bool(interval_type const&). Return false to stop.
+         */
+        template <typename FunctionT>
+        void stab(value_type const& value, FunctionT const& on_find) const
+        {
+            visit(
+                head_levels_,
+                nullptr,
+                max_height - 1,
+                nullptr,
+                [&value](value_type const& max) {
+                    return !(max < value);
+                },
+                [&value](value_type const& low) {
+                    return !(value < low);
+                },
+                [&value](interval_type const& candidate) {
+                    return candidate.within(value);
+                },
+                on_find
+            );
+        }
+
+        /**
+         *  Calls function for every interval in ascending order of low.
+         *
+         *  @param function A function of type bool(interval_type const&). Return false to stop.
+         */
+        template <typename FunctionT>
+        void for_each(FunctionT const& function) const
+        {
+            for (auto* node = head_levels_[0].next.load(); node != nullptr; node = node->levels[0].next.load())
+            {
+                if (!function(static_cast<interval_type const&>(node->interval)))
+                    return;
+            }
+        }
+
+        /**
+         *  The amount of intervals whose insert has returned.
+         */
+        size_type size() const noexcept
+        {
+            return size_.load();
+        }
+
+        bool empty() const noexcept
+        {
+            return size() == 0;
+        }
+
+        allocator_type get_allocator() const
+        {
+            return alloc_;
+        }
+
+      private:
+        /**
+         *  Whether node goes before the inserted node. Equal lows are ordered by address, so every level agrees
+         *  on the order of towers.
+         */
+        static bool goes_before(node_type const* node, node_type const* inserted)
+        {
+            auto const& low = inserted->interval.low();
+            if (node->interval.low() < low)
+                return true;
+            return !(low < node->interval.low()) && std::less<node_type const*>{}(node, inserted);
+        }
+
+        /**
+         *  Finds the predecessor and successor of inserted on every level.
+         */
+        void find_position(node_type const* inserted, skip_level** preds, node_type** succs) const
+        {
+            auto* current = head_levels_;
+            for (int level = max_height - 1; level >= 0; --level)
+            {
+                auto* next = current[level].next.load();
+                while (next != nullptr && goes_before(next, inserted))
+                {
+                    current = next->levels;
+                    next = current[level].next.load();
+                }
+                preds[level] = current;
+                succs[level] = next;
+            }
+        }
+
+        /**
+         *  Raises the max of the segment that inserted falls into on every level above its tower, starting from
+         *  the predecessors that were found before it was linked. The max is raised before the next of the level
+         *  is read again: a tower that is linked in between is either seen and raised instead, or it is linked
+         *  later and its summary already finds inserted in the bottom level.
+         */
+        static void raise_segments(node_type const* inserted, skip_level* const* preds)
+        {
+            for (int level = inserted->height; level != max_height; ++level)
+            {
+                auto* current = preds[level];
+                auto* next = current[level].next.load();
+                while (true)
+                {
+                    if (next != nullptr && goes_before(next, inserted))
+                    {
+                        current = next->levels;
+                        next = current[level].next.load();
+                        continue;
+                    }
+                    detail::atomic_raise(current[level].max, inserted->interval.high());
+                    auto* confirmed = current[level].next.load();
+                    if (confirmed == next)
+                        break;
+                    next = confirmed;
+                }
+            }
+        }
+
+        /**
+         *  Computes the max of the segment of a freshly linked level from the bottom level and lets queries trust
+         *  it. A segment of level n spans 4^n towers on average, which is as unlikely as a tower of that height.
+         */
+        static void summarize(node_type* inserted, int level)
+        {
+            auto& link = inserted->levels[level];
+            node_type const* end = link.next.load();
+            auto max = inserted->interval.high();
+            for (auto* node = inserted->levels[0].next.load(); node != end; node = node->levels[0].next.load())
+            {
+                if (max < node->interval.high())
+                    max = node->interval.high();
+            }
+            detail::atomic_raise(link.max, max);
+            link.summarized.store(true);
+        }
+
+        /**
+         *  Walks the segments of one level from current up to end and descends into those that may hold matches.
+         *  The next of a level is read once, after its max, so the segment that was checked is the one that is
+         *  visited below and the walk goes on from there.
+         */
+        template <typename SegmentReachesT, typename LowReachesT, typename MatchesT, typename FunctionT>
+        bool visit(
+            skip_level const* current,
+            node_type const* current_node,
+            int level,
+            node_type const* end,
+            SegmentReachesT const& segment_reaches,
+            LowReachesT const& low_reaches,
+            MatchesT const& matches,
+            FunctionT const& on_find
+        ) const
+        {
+            while (true)
+            {
+                auto const& link = current[level];
+                const bool descend = level == 0 || !link.summarized.load() || segment_reaches(link.max.load());
+                node_type const* next = link.next.load();
+                if (level == 0)
+                {
+                    if (current_node != nullptr && matches(current_node->interval) &&
+                        !on_find(static_cast<interval_type const&>(current_node->interval)))
+                    {
+                        return false;
+                    }
+                }
+                else if (descend)
+                {
+                    if (!visit(current, current_node, level - 1, next, segment_reaches, low_reaches, matches, on_find))
+                        return false;
+                }
+                // Everything from next on starts at next->interval.low() or later.
+                if (next == end || !low_reaches(next->interval.low()))
+                    return true;
+                current = next->levels;
+                current_node = next;
+            }
+        }
+
+        /**
+         *  Allocates a node together with its tower, so a step along a level touches one block.
+         */
+        node_type* create_node(interval_type const& ival, int height)
+        {
+            const auto slots = node_slots + static_cast<std::size_t>(height);
+            auto* block = level_allocator_traits::allocate(level_alloc_, slots);
+            auto* levels = block + node_slots;
+            for (int level = 0; level != height; ++level)
+                level_allocator_traits::construct(level_alloc_, levels + level, ival.high(), level == 0);
+            try
+            {
+                return ::new (static_cast<void*>(block)) node_type(ival, height, levels);
+            }
+            catch (...)
+            {
+                destroy_levels(levels, height);
+                level_allocator_traits::deallocate(level_alloc_, block, slots);
+                throw;
+            }
+        }
+
+        void destroy_node(node_type* node)
+        {
+            const int height = node->height;
+            auto* levels = node->levels;
+            node->~node_type();
+            destroy_levels(levels, height);
+            level_allocator_traits::deallocate(
+                level_alloc_, levels - node_slots, node_slots + static_cast<std::size_t>(height)
+            );
+        }
+
+        void destroy_levels(skip_level* levels, int height)
+        {
+            for (int level = 0; level != height; ++level)
+                level_allocator_traits::destroy(level_alloc_, levels + level);
+        }
+
+      private:
+        allocator_type alloc_;
+        level_allocator_type level_alloc_;
+        skip_level* head_levels_;
+        std::atomic<size_type> size_;
+    };
+}
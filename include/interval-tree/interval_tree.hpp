@@ -5,16 +5,27 @@
 #include "tree_hooks.hpp"
 #include "feature_test.hpp"
 #include "optional.hpp"
+#include "static_interval_index.hpp"
+#include "augmentations.hpp"
 
 #include <string>
 #include <stdexcept>
 #include <iterator>
 #include <type_traits>
+#include <memory>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <algorithm>
+#include <utility>
+#include <vector>
 
 namespace lib_interval_tree
 {
     // ############################################################################################################
-    enum class rb_color
+    // Stored in the two low bits of the parent pointer of a pointer linked node, see detail::node_links.
+    enum class rb_color : unsigned char
     {
         fail,
         red,
@@ -53,6 +64,83 @@ namespace lib_interval_tree
         template <typename interval_t>
         constexpr bool has_slice = has_slice_impl<interval_t>::value;
 #endif
+
+        // std::allocator_traits::is_always_equal is C++17, fall back to the definition of the standard.
+        template <typename allocator_t, typename = void>
+        struct allocator_is_always_equal : std::is_empty<allocator_t>
+        {};
+
+        template <typename allocator_t>
+        struct allocator_is_always_equal<allocator_t, void_t<typename allocator_t::is_always_equal>>
+            : allocator_t::is_always_equal
+        {};
+
+        // Allocators that can free all of their allocations at once, see arena_allocator.
+        template <typename allocator_t, typename = void>
+        struct has_bulk_release : std::false_type
+        {};
+
+        template <typename allocator_t>
+        struct has_bulk_release<
+            allocator_t,
+            void_t<
+                decltype(std::declval<allocator_t const&>().can_release_all()),
+                decltype(std::declval<allocator_t&>().release_all())>> : std::true_type
+        {};
+
+        // The augmentation of the hooks, void if they have none, see hooks::with_augmentation.
+        template <typename hooks_t, typename = void>
+        struct hook_augmentation
+        {
+            using type = void;
+        };
+
+        template <typename hooks_t>
+        struct hook_augmentation<hooks_t, void_t<typename hooks_t::augmentation>>
+        {
+            using type = typename hooks_t::augmentation;
+        };
+
+        template <typename augmentation_t>
+        struct augmentation_value
+        {
+            using type = typename augmentation_t::value_type;
+        };
+
+        template <>
+        struct augmentation_value<void>
+        {
+            using type = void;
+        };
+
+        // Whether the aggregates of an augmentation are subtree sizes, which order statistics need.
+        template <typename augmentation_t>
+        struct is_count_augmentation : std::false_type
+        {};
+
+        template <typename size_type>
+        struct is_count_augmentation<augmentations::count<size_type>> : std::true_type
+        {};
+
+        // Whether the augmentation refreshes a node from the node and its children, instead of combining aggregates.
+        template <typename augmentation_t, typename node_type, typename = void>
+        struct aggregates_from_node : std::false_type
+        {};
+
+        template <typename augmentation_t, typename node_type>
+        struct aggregates_from_node<
+            augmentation_t,
+            node_type,
+            void_t<decltype(augmentation_t::from_node(std::declval<node_type const&>()))>> : std::true_type
+        {};
+
+        template <typename augmentation_t>
+        struct is_union_measure_augmentation : std::false_type
+        {};
+
+        template <typename numerical_type>
+        struct is_union_measure_augmentation<augmentations::union_measure<numerical_type>> : std::true_type
+        {};
     }
     // ############################################################################################################
     template <typename numerical_type, typename interval_kind_>
@@ -85,7 +173,6 @@ namespace lib_interval_tree
             , high_{std::max(low, high)}
         {}
 #endif
-        virtual ~interval_base() = default;
 
         /**
          *  Returns the lower bound of the interval
@@ -103,6 +190,10 @@ namespace lib_interval_tree
             return high_;
         }
 
+      protected:
+        // Not virtual, intervals are never owned through a base pointer and a vptr would bloat every node.
+        ~interval_base() = default;
+
       protected:
         value_type low_;
         value_type high_;
@@ -445,28 +536,337 @@ namespace lib_interval_tree
         return interval<numerical_type, interval_kind_>{std::min(lhs, rhs), std::max(lhs, rhs)};
     }
     // ############################################################################################################
+    namespace detail
+    {
+        /**
+         *  Bounds that overlap searches prune with. An interval can only overlap ival, if its high reaches
+         *  ival (high_reaches) and its low does not lie beyond it (low_reaches).
+         *  Searches test high_reaches against the max of a subtree and low_reaches against the low of a node,
+         *  which is a lower bound for all lows in its right subtree.
+         *  high_reaches only looks at the low of ival, so it holds for a prefix of queries sorted by low.
+         *  high_reaches_low and low_reaches_high are the same tests on plain values, for joins where both sides
+         *  are bounds.
+         *
+         *  Types other than interval<T, Kind> may redefine overlaps, so they only get the max bound.
+         */
+        template <typename interval_type>
+        struct overlap_bounds
+        {
+            template <typename value_type>
+            static bool high_reaches_low(value_type const& high, value_type const& low)
+            {
+                return high >= low;
+            }
+
+            template <typename value_type>
+            static bool low_reaches_high(value_type const&, value_type const&)
+            {
+                return true;
+            }
+
+            template <typename value_type>
+            static bool high_reaches(value_type const& high, interval_type const& ival)
+            {
+                return high_reaches_low(high, ival.low());
+            }
+
+            template <typename value_type>
+            static bool low_reaches(value_type const&, interval_type const&)
+            {
+                return true;
+            }
+        };
+
+        template <bool high_strict, bool low_strict>
+        struct border_overlap_bounds
+        {
+            template <typename value_type>
+            static bool high_reaches_low(value_type const& high, value_type const& low)
+            {
+                return high_strict ? low < high : !(high < low);
+            }
+
+            template <typename value_type>
+            static bool low_reaches_high(value_type const& low, value_type const& high)
+            {
+                return low_strict ? low < high : !(high < low);
+            }
+
+            template <typename value_type, typename interval_type>
+            static bool high_reaches(value_type const& high, interval_type const& ival)
+            {
+                return high_reaches_low(high, ival.low());
+            }
+
+            template <typename value_type, typename interval_type>
+            static bool low_reaches(value_type const& low, interval_type const& ival)
+            {
+                return low_reaches_high(low, ival.high());
+            }
+        };
+
+        /**
+         *  Hints the cpu to load the node, so it is in cache when a search gets to it.
+         */
+        inline void prefetch(void const* address) noexcept
+        {
+#if defined(__GNUC__) || defined(__clang__)
+            __builtin_prefetch(address);
+#else
+            (void)address;
+#endif
+        }
+
+        /**
+         *  Amount of queries that overlap_find_batch keeps in flight at once.
+         */
+        constexpr std::size_t batch_width = 16;
+
+        /**
+         *  Touching intervals overlap as well, one off in either direction still reaches.
+         */
+        struct adjacent_overlap_bounds
+        {
+            template <typename value_type>
+            static bool high_reaches_low(value_type const& high, value_type const& low)
+            {
+                return high == std::numeric_limits<value_type>::max() || !(high + 1 < low);
+            }
+
+            template <typename value_type>
+            static bool low_reaches_high(value_type const& low, value_type const& high)
+            {
+                return high == std::numeric_limits<value_type>::max() || !(high + 1 < low);
+            }
+
+            template <typename value_type, typename interval_type>
+            static bool high_reaches(value_type const& high, interval_type const& ival)
+            {
+                return high_reaches_low(high, ival.low());
+            }
+
+            template <typename value_type, typename interval_type>
+            static bool low_reaches(value_type const& low, interval_type const& ival)
+            {
+                return low_reaches_high(low, ival.high());
+            }
+        };
+
+        template <typename numerical_type>
+        struct overlap_bounds<interval<numerical_type, closed>> : border_overlap_bounds<false, false>
+        {};
+
+        template <typename numerical_type>
+        struct overlap_bounds<interval<numerical_type, right_open>> : border_overlap_bounds<true, false>
+        {};
+
+        template <typename numerical_type>
+        struct overlap_bounds<interval<numerical_type, left_open>> : border_overlap_bounds<false, true>
+        {};
+
+        template <typename numerical_type>
+        struct overlap_bounds<interval<numerical_type, open>> : border_overlap_bounds<true, true>
+        {};
+
+        template <typename numerical_type>
+        struct overlap_bounds<interval<numerical_type, closed_adjacent>> : adjacent_overlap_bounds
+        {};
+
+        // Borders differ per interval, closed_adjacent ones reach furthest.
+        template <typename numerical_type>
+        struct overlap_bounds<interval<numerical_type, dynamic>> : adjacent_overlap_bounds
+        {};
+    }
+    // ############################################################################################################
+    /**
+     *  Nodes link to each other with plain pointers. This is the default.
+     */
+    struct pointer_links
+    {};
+
+    /**
+     *  Nodes link to each other with 32 bit offsets relative to themselves and the tree keeps all of them in one
+     *  contiguous block. This halves the link overhead and keeps traversals within fewer pages.
+     *  Inserting may move the block, which invalidates all iterators, like std::vector::push_back does.
+     *  A tree can hold at most 2^31 - 1 nodes and the nodes must be trivially copyable.
+     */
+    struct index_links
+    {};
+    // ############################################################################################################
+    namespace detail
+    {
+        template <typename node_type, typename link_type>
+        class node_links;
+
+        template <typename node_type>
+        class node_links<node_type, pointer_links>
+        {
+          protected:
+            node_links() noexcept
+                : parent_and_color_{0}
+                , left_{nullptr}
+                , right_{nullptr}
+            {}
+
+            node_type* parent_ptr() const noexcept
+            {
+                return reinterpret_cast<node_type*>(parent_and_color_ & ~color_mask);
+            }
+
+            node_type* left_ptr() const noexcept
+            {
+                return left_;
+            }
+
+            node_type* right_ptr() const noexcept
+            {
+                return right_;
+            }
+
+            void set_parent(node_type* parent) noexcept
+            {
+                parent_and_color_ = reinterpret_cast<std::uintptr_t>(parent) | (parent_and_color_ & color_mask);
+            }
+
+            void set_left(node_type* left) noexcept
+            {
+                left_ = left;
+            }
+
+            void set_right(node_type* right) noexcept
+            {
+                right_ = right;
+            }
+
+            rb_color color() const noexcept
+            {
+                return static_cast<rb_color>(parent_and_color_ & color_mask);
+            }
+
+            void set_color(rb_color color) noexcept
+            {
+                parent_and_color_ = (parent_and_color_ & ~color_mask) | static_cast<std::uintptr_t>(color);
+            }
+
+          private:
+            // Nodes are at least pointer aligned, which leaves the two low bits of the parent pointer for the color.
+            static constexpr std::uintptr_t color_mask = 0x3;
+            static_assert(alignof(void*) > color_mask, "Pointer alignment leaves no room for the node color.");
+
+            std::uintptr_t parent_and_color_;
+            node_type* left_;
+            node_type* right_;
+        };
+
+        template <typename node_type>
+        class node_links<node_type, index_links>
+        {
+          protected:
+            node_links() noexcept
+                : parent_{0}
+                , left_{0}
+                , right_{0}
+                , color_{rb_color::fail}
+            {}
+
+            node_type* parent_ptr() const noexcept
+            {
+                return resolve(parent_);
+            }
+
+            node_type* left_ptr() const noexcept
+            {
+                return resolve(left_);
+            }
+
+            node_type* right_ptr() const noexcept
+            {
+                return resolve(right_);
+            }
+
+            void set_parent(node_type* parent) noexcept
+            {
+                parent_ = offset_to(parent);
+            }
+
+            void set_left(node_type* left) noexcept
+            {
+                left_ = offset_to(left);
+            }
+
+            void set_right(node_type* right) noexcept
+            {
+                right_ = offset_to(right);
+            }
+
+            rb_color color() const noexcept
+            {
+                return color_;
+            }
+
+            void set_color(rb_color color) noexcept
+            {
+                color_ = color;
+            }
+
+          private:
+            node_type* self() const noexcept
+            {
+                return const_cast<node_type*>(static_cast<node_type const*>(this));
+            }
+
+            // A node never links to itself, so offset 0 is free to mean "no node".
+            node_type* resolve(std::int32_t offset) const noexcept
+            {
+                return offset == 0 ? nullptr : self() + offset;
+            }
+
+            std::int32_t offset_to(node_type const* other) const noexcept
+            {
+                return other == nullptr ? 0 : static_cast<std::int32_t>(other - self());
+            }
+
+            std::int32_t parent_;
+            std::int32_t left_;
+            std::int32_t right_;
+            rb_color color_;
+        };
+    }
+    // ############################################################################################################
     template <
         typename numerical_type = default_interval_value_type,
         typename interval_type_ = interval<numerical_type, closed>,
-        typename derived = void>
+        typename derived = void,
+        typename links = pointer_links>
     class node
+        : public detail::node_links<
+              std::conditional_t<
+                  std::is_same<derived, void>::value,
+                  node<numerical_type, interval_type_, void, links>,
+                  derived>,
+              links>
     {
       protected:
-        using node_type =
-            std::conditional_t<std::is_same<derived, void>::value, node<numerical_type, interval_type_>, derived>;
+        using node_type = std::conditional_t<
+            std::is_same<derived, void>::value,
+            node<numerical_type, interval_type_, void, links>,
+            derived>;
+        using links_type = detail::node_links<node_type, links>;
 
       public:
         using interval_type = interval_type_;
         using value_type = numerical_type;
+        using link_type = links;
 
       public:
-        template <typename interval_type, typename hooks_type>
+        template <typename interval_type, typename hooks_type, typename allocator_type>
         friend class interval_tree;
+        friend detail::parallel_access;
 
-        template <typename node_type, bool reverse, typename tree_hooks>
+        template <typename node_type, bool reverse, typename tree_hooks, typename allocator_type>
         friend class const_interval_tree_iterator;
 
-        template <typename node_type, bool reverse, typename tree_hooks>
+        template <typename node_type, bool reverse, typename tree_hooks, typename allocator_type>
         friend class interval_tree_iterator;
 
         template <typename T>
@@ -476,16 +876,13 @@ namespace lib_interval_tree
 
       public:
         node(node_type* parent, interval_type interval)
-            : interval_{std::move(interval)}
-            , max_{interval.high()}
-            , parent_{parent}
-            , left_{}
-            , right_{}
-            , color_{rb_color::fail}
-        {}
-
-        virtual ~node()
-        {}
+            : links_type{}
+            , interval_{std::move(interval)}
+            , max_{interval_.high()}
+        {
+            if (parent)
+                this->set_parent(parent);
+        }
 
         interval_type const* interval() const
         {
@@ -504,17 +901,17 @@ namespace lib_interval_tree
 
         bool is_left() const noexcept
         {
-            return this == parent_->left_;
+            return this == this->parent_ptr()->left_ptr();
         }
 
         bool is_right() const noexcept
         {
-            return this == parent_->right_;
+            return this == this->parent_ptr()->right_ptr();
         }
 
         bool is_root() const noexcept
         {
-            return !parent_;
+            return !this->parent_ptr();
         }
 
         /**
@@ -522,7 +919,7 @@ namespace lib_interval_tree
          */
         rb_color color() const
         {
-            return color_;
+            return links_type::color();
         }
 
         /**
@@ -530,7 +927,7 @@ namespace lib_interval_tree
          */
         node_type const* parent() const
         {
-            return parent_;
+            return this->parent_ptr();
         }
 
         /**
@@ -538,7 +935,7 @@ namespace lib_interval_tree
          */
         node_type const* left() const
         {
-            return left_;
+            return this->left_ptr();
         }
 
         /**
@@ -546,7 +943,7 @@ namespace lib_interval_tree
          */
         node_type const* right() const
         {
-            return right_;
+            return this->right_ptr();
         }
 
         /**
@@ -556,7 +953,7 @@ namespace lib_interval_tree
         int height() const
         {
             int counter{0};
-            for (auto* p = parent_; p != nullptr; p = p->parent_)
+            for (auto* p = this->parent_ptr(); p != nullptr; p = p->parent_ptr())
                 ++counter;
             return counter;
         }
@@ -583,38 +980,121 @@ namespace lib_interval_tree
             interval_ = ival;
         }
 
-        void kill() const noexcept
+      protected:
+        interval_type interval_;
+        value_type max_;
+    };
+    // ############################################################################################################
+    namespace detail
+    {
+        /**
+         *  Size of a node without any overhead beyond the interval, max and three links.
+         */
+        template <typename value_t, typename interval_t>
+        constexpr std::size_t compact_node_size()
+        {
+            return (sizeof(interval_t) + sizeof(value_t) + alignof(void*) - 1) / alignof(void*) * alignof(void*) +
+                3 * sizeof(void*);
+        }
+    }
+
+    static_assert(
+        sizeof(node<int, interval<int, closed>>) <= detail::compact_node_size<int, interval<int, closed>>(),
+        "Nodes of default intervals must not carry vtables or a separate color field."
+    );
+    static_assert(
+        sizeof(node<int, interval<int, right_open>>) <= detail::compact_node_size<int, interval<int, right_open>>(),
+        "Nodes of default intervals must not carry vtables or a separate color field."
+    );
+    static_assert(
+        sizeof(node<long long, interval<long long, closed>>) <=
+            detail::compact_node_size<long long, interval<long long, closed>>(),
+        "Nodes of default intervals must not carry vtables or a separate color field."
+    );
+    static_assert(
+        sizeof(node<double, interval<double, closed>>) <=
+            detail::compact_node_size<double, interval<double, closed>>(),
+        "Nodes of default intervals must not carry vtables or a separate color field."
+    );
+    static_assert(
+        sizeof(node<int, interval<int, dynamic>>) <= detail::compact_node_size<int, interval<int, dynamic>>(),
+        "Nodes of default intervals must not carry vtables or a separate color field."
+    );
+    static_assert(
+        sizeof(node<int, interval<int, closed>, void, index_links>) <=
+            sizeof(interval<int, closed>) + sizeof(int) + 4 * sizeof(std::int32_t),
+        "Index linked nodes must only carry three 32 bit links and the color on top of the interval and max."
+    );
+    static_assert(
+        std::is_trivially_destructible<node<int, interval<int, closed>>>::value,
+        "Nodes of default intervals must be trivially destructible, so arenas can drop them in bulk."
+    );
+    // ############################################################################################################
+    /**
+     *  A node that also keeps the aggregate of an augmentation over all intervals of its subtree.
+     *  Trees use it when their hooks have an augmentation, see hooks::with_augmentation.
+     */
+    template <
+        typename numerical_type,
+        typename interval_type_,
+        typename augmentation,
+        typename derived = void,
+        typename links = pointer_links>
+    class augmented_node
+        : public node<
+              numerical_type,
+              interval_type_,
+              std::conditional_t<
+                  std::is_same<derived, void>::value,
+                  augmented_node<numerical_type, interval_type_, augmentation, void, links>,
+                  derived>,
+              links>
+    {
+      protected:
+        using base_type = node<
+            numerical_type,
+            interval_type_,
+            std::conditional_t<
+                std::is_same<derived, void>::value,
+                augmented_node<numerical_type, interval_type_, augmentation, void, links>,
+                derived>,
+            links>;
+        using node_type = typename base_type::node_type;
+
+      public:
+        using augmentation_type = augmentation;
+        using aggregate_type = typename augmentation::value_type;
+
+        template <typename interval_type, typename hooks_type, typename allocator_type>
+        friend class interval_tree;
+        friend detail::parallel_access;
+
+      public:
+        augmented_node(node_type* parent, interval_type_ interval)
+            : base_type{parent, std::move(interval)}
+            , aggregate_{augmentation::from_interval(this->interval_)}
+        {}
+
+        /**
+         *  The aggregate of all intervals in the subtree of this node.
+         */
+        aggregate_type const& aggregate() const
         {
-            auto* parent = parent_;
-            if (is_left())
-            {
-                delete parent_->left_;
-                parent->left_ = nullptr;
-            }
-            else
-            {
-                delete parent_->right_;
-                parent->right_ = nullptr;
-            }
+            return aggregate_;
         }
 
       protected:
-        interval_type interval_;
-        value_type max_;
-        node_type* parent_;
-        node_type* left_;
-        node_type* right_;
-        rb_color color_;
+        aggregate_type aggregate_;
     };
     // ############################################################################################################
-    template <typename node_type, typename owner_type, typename tree_hooks>
+    template <typename node_type, typename owner_type, typename tree_hooks, typename allocator_type>
     class basic_interval_tree_iterator : public std::forward_iterator_tag
     {
       public:
-        friend interval_tree<typename node_type::interval_type, tree_hooks>;
+        friend interval_tree<typename node_type::interval_type, tree_hooks, allocator_type>;
 
         using tree_hooks_type = tree_hooks;
-        using tree_type = interval_tree<typename node_type::interval_type, tree_hooks_type>;
+        using tree_type = interval_tree<typename node_type::interval_type, tree_hooks_type, allocator_type>;
         using value_type = node_type;
 
         using node_ptr_t = typename std::conditional<
@@ -682,17 +1162,18 @@ namespace lib_interval_tree
     template <typename T>
     inline void increment_reverse(T& iter);
     // ############################################################################################################
-    template <typename node_type, bool reverse, typename tree_hooks>
+    template <typename node_type, bool reverse, typename tree_hooks, typename allocator_type>
     class const_interval_tree_iterator
         : public basic_interval_tree_iterator<
               node_type,
-              interval_tree<typename node_type::interval_type, tree_hooks> const*,
-              tree_hooks>
+              interval_tree<typename node_type::interval_type, tree_hooks, allocator_type> const*,
+              tree_hooks,
+              allocator_type>
     {
       public:
         using tree_hooks_type = tree_hooks;
-        using tree_type = interval_tree<typename node_type::interval_type, tree_hooks_type>;
-        using iterator_base = basic_interval_tree_iterator<node_type, tree_type const*, tree_hooks>;
+        using tree_type = interval_tree<typename node_type::interval_type, tree_hooks_type, allocator_type>;
+        using iterator_base = basic_interval_tree_iterator<node_type, tree_type const*, tree_hooks, allocator_type>;
         using value_type = typename iterator_base::value_type;
         using iterator_base::node_;
         using iterator_base::owner_;
@@ -747,7 +1228,7 @@ namespace lib_interval_tree
         const_interval_tree_iterator parent() const
         {
             if (node_)
-                return {node_->parent_, owner_};
+                return {node_->parent_ptr(), owner_};
             else
                 throw std::out_of_range("interval_tree_iterator out of bounds");
         }
@@ -759,7 +1240,7 @@ namespace lib_interval_tree
         const_interval_tree_iterator left() const
         {
             if (node_)
-                return {node_->left_, owner_};
+                return {node_->left_ptr(), owner_};
             else
                 throw std::out_of_range("interval_tree_iterator out of bounds");
         }
@@ -771,7 +1252,7 @@ namespace lib_interval_tree
         const_interval_tree_iterator right() const
         {
             if (node_)
-                return {node_->right_, owner_};
+                return {node_->right_ptr(), owner_};
             else
                 throw std::out_of_range("interval_tree_iterator out of bounds");
         }
@@ -786,21 +1267,22 @@ namespace lib_interval_tree
 
       private:
         const_interval_tree_iterator(node_type const* node, tree_type const* owner)
-            : basic_interval_tree_iterator<node_type, tree_type const*, tree_hooks>{node, owner}
+            : iterator_base{node, owner}
         {}
     };
     // ############################################################################################################
-    template <typename node_type, bool reverse, typename tree_hooks>
+    template <typename node_type, bool reverse, typename tree_hooks, typename allocator_type>
     class interval_tree_iterator
         : public basic_interval_tree_iterator<
               node_type,
-              interval_tree<typename node_type::interval_type, tree_hooks>*,
-              tree_hooks>
+              interval_tree<typename node_type::interval_type, tree_hooks, allocator_type>*,
+              tree_hooks,
+              allocator_type>
     {
       public:
         using tree_hooks_type = tree_hooks;
-        using tree_type = interval_tree<typename node_type::interval_type, tree_hooks_type>;
-        using iterator_base = basic_interval_tree_iterator<node_type, tree_type*, tree_hooks>;
+        using tree_type = interval_tree<typename node_type::interval_type, tree_hooks_type, allocator_type>;
+        using iterator_base = basic_interval_tree_iterator<node_type, tree_type*, tree_hooks, allocator_type>;
         using value_type = typename iterator_base::value_type;
         using iterator_base::node_;
         using iterator_base::owner_;
@@ -847,7 +1329,7 @@ namespace lib_interval_tree
         interval_tree_iterator parent()
         {
             if (node_)
-                return {node_->parent_, owner_};
+                return {node_->parent_ptr(), owner_};
             else
                 throw std::out_of_range("interval_tree_iterator out of bounds");
         }
@@ -859,7 +1341,7 @@ namespace lib_interval_tree
         interval_tree_iterator left()
         {
             if (node_)
-                return {node_->left_, owner_};
+                return {node_->left_ptr(), owner_};
             else
                 throw std::out_of_range("interval_tree_iterator out of bounds");
         }
@@ -871,7 +1353,7 @@ namespace lib_interval_tree
         interval_tree_iterator right()
         {
             if (node_)
-                return {node_->right_, owner_};
+                return {node_->right_ptr(), owner_};
             else
                 throw std::out_of_range("interval_tree_iterator out of bounds");
         }
@@ -894,7 +1376,7 @@ namespace lib_interval_tree
 
       private:
         interval_tree_iterator(node_type* node, tree_type* owner)
-            : basic_interval_tree_iterator<node_type, tree_type*, tree_hooks>{node, owner}
+            : iterator_base{node, owner}
         {}
     };
     // ############################################################################################################
@@ -908,24 +1390,24 @@ namespace lib_interval_tree
             if (!iter.node_)
                 return;
 
-            while (iter.node_->left_)
-                iter.node_ = iter.node_->left_;
+            while (iter.node_->left_ptr())
+                iter.node_ = iter.node_->left_ptr();
         }
 
-        if (iter.node_->right_)
+        if (iter.node_->right_ptr())
         {
-            iter.node_ = iter.node_->right_;
+            iter.node_ = iter.node_->right_ptr();
 
-            while (iter.node_->left_)
-                iter.node_ = iter.node_->left_;
+            while (iter.node_->left_ptr())
+                iter.node_ = iter.node_->left_ptr();
         }
         else
         {
-            auto* parent = iter.node_->parent_;
-            while (parent != nullptr && iter.node_ == parent->right_)
+            auto* parent = iter.node_->parent_ptr();
+            while (parent != nullptr && iter.node_ == parent->right_ptr())
             {
                 iter.node_ = parent;
-                parent = parent->parent_;
+                parent = parent->parent_ptr();
             }
             iter.node_ = parent;
         }
@@ -940,73 +1422,336 @@ namespace lib_interval_tree
             if (!iter.node_)
                 return;
 
-            while (iter.node_->right_)
-                iter.node_ = iter.node_->right_;
+            while (iter.node_->right_ptr())
+                iter.node_ = iter.node_->right_ptr();
         }
 
-        if (iter.node_->left_)
+        if (iter.node_->left_ptr())
         {
-            iter.node_ = iter.node_->left_;
+            iter.node_ = iter.node_->left_ptr();
 
-            while (iter.node_->right_)
-                iter.node_ = iter.node_->right_;
+            while (iter.node_->right_ptr())
+                iter.node_ = iter.node_->right_ptr();
         }
         else
         {
-            auto* parent = iter.node_->parent_;
-            while (parent != nullptr && iter.node_ == parent->left_)
+            auto* parent = iter.node_->parent_ptr();
+            while (parent != nullptr && iter.node_ == parent->left_ptr())
             {
                 iter.node_ = parent;
-                parent = parent->parent_;
+                parent = parent->parent_ptr();
             }
             iter.node_ = parent;
         }
     }
     // ############################################################################################################
-    template <typename IntervalT = interval<int, closed>, typename tree_hooks = hooks::regular>
-    class interval_tree : public tree_hooks::hook_state
+    namespace detail
     {
-      public:
-        using interval_type = IntervalT;
-        using tree_hooks_type = tree_hooks;
-        using value_type = typename interval_type::value_type;
+        template <typename node_type>
+        using is_index_linked = std::is_same<typename node_type::link_type, index_links>;
 
-        // Node type:
-        using node_type = std::conditional_t<
-            std::is_same<typename tree_hooks::node_type, void>::value,
-            node<value_type, interval_type>,
-            typename tree_hooks::node_type>;
+        /**
+         *  Every node is a separate allocation.
+         */
+        template <typename node_type, typename node_allocator_type, bool contiguous = is_index_linked<node_type>::value>
+        class node_storage
+        {
+          public:
+            using traits = std::allocator_traits<node_allocator_type>;
 
-        // Iterators:
-        using iterator = interval_tree_iterator<node_type, false, tree_hooks>;
-        using const_iterator = const_interval_tree_iterator<node_type, false, tree_hooks>;
-        using reverse_iterator = interval_tree_iterator<node_type, true, tree_hooks>;
-        using const_reverse_iterator = const_interval_tree_iterator<node_type, true, tree_hooks>;
+            explicit node_storage(node_allocator_type const& allocator)
+                : allocator_{allocator}
+            {}
 
-        // Size type:
-        using size_type = std::conditional_t<
-            std::is_same<typename tree_hooks::size_type, void>::value,
-            long long,
-            typename tree_hooks::size_type>;
+            explicit node_storage(node_allocator_type&& allocator) noexcept
+                : allocator_{std::move(allocator)}
+            {}
 
-        using this_type = interval_tree<interval_type, tree_hooks>;
+            node_allocator_type& allocator() noexcept
+            {
+                return allocator_;
+            }
 
-      public:
-        friend const_interval_tree_iterator<node_type, true, tree_hooks>;
-        friend const_interval_tree_iterator<node_type, false, tree_hooks>;
-        friend interval_tree_iterator<node_type, true, tree_hooks>;
-        friend interval_tree_iterator<node_type, false, tree_hooks>;
-        friend tree_hooks;
+            node_allocator_type const& allocator() const noexcept
+            {
+                return allocator_;
+            }
 
-        template <typename T>
-        friend void increment(T& iter);
-        template <typename T>
-        friend void increment_reverse(T& iter);
+            node_type* allocate(node_type*& /*root*/)
+            {
+                return traits::allocate(allocator_, 1);
+            }
 
-      public:
+            void deallocate(node_type* node) noexcept
+            {
+                traits::deallocate(allocator_, node, 1);
+            }
+
+            void reserve(std::size_t, node_type*&)
+            {}
+
+            void release() noexcept
+            {}
+
+            void take(node_storage&) noexcept
+            {}
+
+          private:
+            node_allocator_type allocator_;
+        };
+
+        /**
+         *  All nodes of a tree live in one block, which is only possible for index linked nodes.
+         *  Growing moves the block as a whole, so the relative links stay valid.
+         *  Freed slots are kept in a free list, that is threaded through the slots by index.
+         */
+        template <typename node_type, typename node_allocator_type>
+        class node_storage<node_type, node_allocator_type, true>
+        {
+          public:
+            using traits = std::allocator_traits<node_allocator_type>;
+
+            static_assert(
+                std::is_trivially_copyable<node_type>::value,
+                "Index linked nodes are relocated with memcpy and must be trivially copyable."
+            );
+
+            static constexpr std::size_t max_nodes = static_cast<std::size_t>(std::numeric_limits<std::int32_t>::max());
+
+            explicit node_storage(node_allocator_type const& allocator)
+                : allocator_{allocator}
+                , nodes_{nullptr}
+                , capacity_{0}
+                , used_{0}
+                , free_{no_slot}
+            {}
+
+            explicit node_storage(node_allocator_type&& allocator) noexcept
+                : allocator_{std::move(allocator)}
+                , nodes_{nullptr}
+                , capacity_{0}
+                , used_{0}
+                , free_{no_slot}
+            {}
+
+            ~node_storage()
+            {
+                release();
+            }
+
+            node_storage(node_storage const&) = delete;
+            node_storage& operator=(node_storage const&) = delete;
+
+            node_allocator_type& allocator() noexcept
+            {
+                return allocator_;
+            }
+
+            node_allocator_type const& allocator() const noexcept
+            {
+                return allocator_;
+            }
+
+            /**
+             *  Returns memory for one node. Might move all nodes, root is adjusted if it does.
+             */
+            node_type* allocate(node_type*& root)
+            {
+                if (free_ != no_slot)
+                {
+                    auto* slot = nodes_ + free_;
+                    std::memcpy(&free_, static_cast<void const*>(slot), sizeof(free_));
+                    return slot;
+                }
+                if (used_ == capacity_)
+                {
+                    if (used_ == max_nodes)
+                        throw_too_many_nodes();
+                    reserve(used_ < 8 ? 16 : std::min(used_ * 2, std::size_t{max_nodes}), root);
+                }
+                return nodes_ + used_++;
+            }
+
+            /**
+             *  Puts the slot of an already destroyed node on the free list.
+             */
+            void deallocate(node_type* node) noexcept
+            {
+                std::memcpy(static_cast<void*>(node), &free_, sizeof(free_));
+                free_ = static_cast<std::uint32_t>(node - nodes_);
+            }
+
+            void reserve(std::size_t capacity, node_type*& root)
+            {
+                if (capacity <= capacity_)
+                    return;
+                if (capacity > max_nodes)
+                    throw_too_many_nodes();
+
+                node_type* nodes = traits::allocate(allocator_, capacity);
+                if (used_ != 0)
+                    std::memcpy(static_cast<void*>(nodes), static_cast<void const*>(nodes_), used_ * sizeof(node_type));
+                if (root)
+                    root = nodes + (root - nodes_);
+                if (nodes_)
+                    traits::deallocate(allocator_, nodes_, capacity_);
+                nodes_ = nodes;
+                capacity_ = capacity;
+            }
+
+            /**
+             *  Forgets all nodes, but keeps the block for reuse. Nodes are trivially destructible.
+             */
+            void reset() noexcept
+            {
+                used_ = 0;
+                free_ = no_slot;
+            }
+
+            /**
+             *  Forgets all nodes and frees the block.
+             */
+            void release() noexcept
+            {
+                reset();
+                if (nodes_)
+                    traits::deallocate(allocator_, nodes_, capacity_);
+                nodes_ = nullptr;
+                capacity_ = 0;
+            }
+
+            /**
+             *  Takes over the block of other, only valid if both allocators compare equal.
+             */
+            void take(node_storage& other) noexcept
+            {
+                release();
+                nodes_ = other.nodes_;
+                capacity_ = other.capacity_;
+                used_ = other.used_;
+                free_ = other.free_;
+                other.nodes_ = nullptr;
+                other.capacity_ = 0;
+                other.reset();
+            }
+
+            /**
+             *  Copies all slots of other with a single memcpy and returns where the root of other ended up.
+             */
+            node_type* copy(node_storage const& other, node_type const* root)
+            {
+                reset();
+                node_type* no_root = nullptr;
+                reserve(other.used_, no_root);
+                if (other.used_ != 0)
+                {
+                    std::memcpy(
+                        static_cast<void*>(nodes_),
+                        static_cast<void const*>(other.nodes_),
+                        other.used_ * sizeof(node_type)
+                    );
+                }
+                used_ = other.used_;
+                free_ = other.free_;
+                return root ? nodes_ + (root - other.nodes_) : nullptr;
+            }
+
+            std::size_t capacity() const noexcept
+            {
+                return capacity_;
+            }
+
+          private:
+            [[noreturn]] static void throw_too_many_nodes()
+            {
+                throw std::length_error("index linked interval_tree cannot hold more than 2^31 - 1 nodes");
+            }
+
+          private:
+            static constexpr std::uint32_t no_slot = std::numeric_limits<std::uint32_t>::max();
+
+            node_allocator_type allocator_;
+            node_type* nodes_;
+            std::size_t capacity_;
+            std::size_t used_;
+            std::uint32_t free_;
+        };
+    }
+    // ############################################################################################################
+    template <
+        typename IntervalT = interval<int, closed>,
+        typename tree_hooks = hooks::regular,
+        typename Allocator = std::allocator<IntervalT>>
+    class interval_tree : public tree_hooks::hook_state
+    {
+      public:
+        using interval_type = IntervalT;
+        using tree_hooks_type = tree_hooks;
+        using value_type = typename interval_type::value_type;
+        using allocator_type = Allocator;
+
+        // Augmentation, void if the hooks have none, see hooks::with_augmentation:
+        using augmentation_type = typename detail::hook_augmentation<tree_hooks>::type;
+        using aggregate_type = typename detail::augmentation_value<augmentation_type>::type;
+
+        // Node type:
+        using node_type = std::conditional_t<
+            std::is_same<typename tree_hooks::node_type, void>::value,
+            std::conditional_t<
+                std::is_void<augmentation_type>::value,
+                node<value_type, interval_type>,
+                augmented_node<value_type, interval_type, augmentation_type>>,
+            typename tree_hooks::node_type>;
+
+        // Nodes are allocated with the allocator rebound to node_type, like std::map does.
+        using node_allocator_type = typename std::allocator_traits<allocator_type>::template rebind_alloc<node_type>;
+        using node_allocator_traits = std::allocator_traits<node_allocator_type>;
+        using node_storage_type = detail::node_storage<node_type, node_allocator_type>;
+
+        // Iterators:
+        using iterator = interval_tree_iterator<node_type, false, tree_hooks, allocator_type>;
+        using const_iterator = const_interval_tree_iterator<node_type, false, tree_hooks, allocator_type>;
+        using reverse_iterator = interval_tree_iterator<node_type, true, tree_hooks, allocator_type>;
+        using const_reverse_iterator = const_interval_tree_iterator<node_type, true, tree_hooks, allocator_type>;
+
+        // Size type:
+        using size_type = std::conditional_t<
+            std::is_same<typename tree_hooks::size_type, void>::value,
+            long long,
+            typename tree_hooks::size_type>;
+
+        using this_type = interval_tree<interval_type, tree_hooks, allocator_type>;
+
+        static_assert(
+            std::is_same<typename node_allocator_traits::pointer, node_type*>::value,
+            "Allocators with fancy pointers are not supported."
+        );
+
+      private:
+        using has_augmentation = std::integral_constant<bool, !std::is_void<augmentation_type>::value>;
+
+      public:
+        friend const_interval_tree_iterator<node_type, true, tree_hooks, allocator_type>;
+        friend const_interval_tree_iterator<node_type, false, tree_hooks, allocator_type>;
+        friend interval_tree_iterator<node_type, true, tree_hooks, allocator_type>;
+        friend interval_tree_iterator<node_type, false, tree_hooks, allocator_type>;
+        friend tree_hooks;
+        friend detail::parallel_access;
+
+        template <typename T>
+        friend void increment(T& iter);
+        template <typename T>
+        friend void increment_reverse(T& iter);
+
+      public:
         interval_tree()
+            : interval_tree(allocator_type{})
+        {}
+
+        explicit interval_tree(allocator_type const& allocator)
             : root_{nullptr}
             , size_{0}
+            , storage_{allocator}
         {}
 
         ~interval_tree()
@@ -1016,55 +1761,376 @@ namespace lib_interval_tree
         }
 
         interval_tree(interval_tree const& other)
+            : interval_tree(
+                  other,
+                  std::allocator_traits<allocator_type>::select_on_container_copy_construction(other.get_allocator())
+              )
+        {}
+
+        interval_tree(interval_tree const& other, allocator_type const& allocator)
             : root_{nullptr}
             , size_{0}
+            , storage_{allocator}
         {
-            operator=(other);
+            copy_nodes(other, detail::is_index_linked<node_type>{});
+            size_ = other.size_;
         }
 
         interval_tree(interval_tree&& other) noexcept
-            : root_{other.root_}
-            , size_{other.size_}
+            : root_{nullptr}
+            , size_{0}
+            , storage_{std::move(other.storage_.allocator())}
         {
-            other.root_ = nullptr;
-            other.size_ = 0;
+            steal(other);
+            renew_allocator(other);
+        }
+
+        interval_tree(interval_tree&& other, allocator_type const& allocator)
+            : root_{nullptr}
+            , size_{0}
+            , storage_{allocator}
+        {
+            if (storage_.allocator() == other.storage_.allocator())
+                steal(other);
+            else
+                copy_and_clear(other);
         }
 
         interval_tree& operator=(interval_tree const& other)
         {
+            if (this == &other)
+                return *this;
+
             if (!empty())
                 clear();
 
-            if (other.root_ != nullptr)
-                root_ = copy_tree_impl(other.root_, nullptr);
+            propagate_allocator(
+                other.storage_.allocator(), typename node_allocator_traits::propagate_on_container_copy_assignment{}
+            );
+
+            copy_nodes(other, detail::is_index_linked<node_type>{});
 
             size_ = other.size_;
 
             return *this;
         }
 
-        interval_tree& operator=(interval_tree&& other) noexcept
+        interval_tree& operator=(interval_tree&& other) noexcept(
+            node_allocator_traits::propagate_on_container_move_assignment::value ||
+            detail::allocator_is_always_equal<node_allocator_type>::value
+        )
         {
+            if (this == &other)
+                return *this;
+
             if (!empty())
                 clear();
 
-            root_ = other.root_;
-            size_ = other.size_;
-            other.root_ = nullptr;
-            other.size_ = 0;
+            if (node_allocator_traits::propagate_on_container_move_assignment::value)
+            {
+                propagate_allocator(
+                    std::move(other.storage_.allocator()),
+                    typename node_allocator_traits::propagate_on_container_move_assignment{}
+                );
+                steal(other);
+                renew_allocator(other);
+            }
+            else if (storage_.allocator() == other.storage_.allocator())
+                steal(other);
+            else
+                copy_and_clear(other);
+
             return *this;
         }
 
+        /**
+         *  Returns a copy of the allocator the tree was constructed with.
+         */
+        allocator_type get_allocator() const
+        {
+            return allocator_type(storage_.allocator());
+        }
+
+        /**
+         *  Replaces the content of the tree with the intervals of a range that is sorted by low.
+         *  Builds a perfectly balanced tree in linear time, instead of inserting one by one.
+         *  Insert hooks are not called. If an exception is thrown, the tree is left empty.
+         *
+         *  @throws std::invalid_argument if the range is not sorted by low.
+         */
+        template <typename ForwardIteratorT>
+        void assign(ForwardIteratorT first, ForwardIteratorT last)
+        {
+            if (!std::is_sorted(first, last, &low_less))
+                throw std::invalid_argument("assign requires a range sorted by low, use assign_unsorted otherwise.");
+
+            clear();
+            const auto count = static_cast<size_type>(std::distance(first, last));
+            if (count == 0)
+                return;
+
+            // Index linked nodes must not move while subtrees are linked up.
+            reserve(count);
+
+            root_ = build_balanced(first, count, 0, balanced_red_depth(count));
+            size_ = count;
+        }
+
+        /**
+         *  Like assign, but sorts the intervals first.
+         *  See interval_tree_parallel.hpp for a version that sorts on multiple threads.
+         */
+        template <typename InputIteratorT>
+        void assign_unsorted(InputIteratorT first, InputIteratorT last)
+        {
+            std::vector<interval_type> sorted(first, last);
+            std::sort(sorted.begin(), sorted.end(), &low_less);
+            assign(sorted.begin(), sorted.end());
+        }
+
+        /**
+         *  Inserts many intervals at once.
+         *  Big batches (compared to the size of the tree) are sorted and merged with the nodes of the tree,
+         *  which are then relinked into a balanced tree without moving or reallocating them.
+         *  Small batches are inserted one by one. Insert hooks are only called for small batches.
+         *  If an exception is thrown, the tree is left unchanged.
+         */
+        template <typename InputIteratorT>
+        void insert_bulk(InputIteratorT first, InputIteratorT last)
+        {
+            std::vector<interval_type> batch(first, last);
+            if (batch.empty())
+                return;
+
+            const auto batch_size = static_cast<size_type>(batch.size());
+            if (!rebuild_pays_off(batch_size))
+            {
+                for (auto& ival : batch)
+                    insert(std::move(ival));
+                return;
+            }
+
+            std::stable_sort(batch.begin(), batch.end(), &low_less);
+            reserve(size_ + batch_size);
+
+            std::vector<node_type*> nodes;
+            nodes.reserve(static_cast<std::size_t>(size_ + batch_size));
+            if (root_)
+            {
+                for (auto* node = minimum(root_); node != nullptr; node = successor(node))
+                    nodes.push_back(node);
+            }
+            const auto existing = nodes.size();
+            try
+            {
+                for (auto& ival : batch)
+                    nodes.push_back(create_node(nullptr, std::move(ival)));
+            }
+            catch (...)
+            {
+                for (auto i = existing; i != nodes.size(); ++i)
+                    destroy_node(nodes[i]);
+                throw;
+            }
+
+            // Stable, so new intervals go right of existing ones with the same low, like insert does.
+            const auto by_low = [](node_type const* lhs, node_type const* rhs) {
+                return lhs->low() < rhs->low();
+            };
+            std::inplace_merge(
+                nodes.begin(), nodes.begin() + static_cast<std::ptrdiff_t>(existing), nodes.end(), by_low
+            );
+
+            size_ += batch_size;
+            root_ = link_balanced(nodes.data(), size_, 0, balanced_red_depth(size_));
+            root_->set_parent(nullptr);
+        }
+
+        /**
+         *  Returns an immutable copy of this tree that is faster to query, see static_interval_index.
+         */
+        static_interval_index<interval_type, allocator_type> freeze() const
+        {
+            return static_interval_index<interval_type, allocator_type>{*this};
+        }
+
+        /**
+         *  Combines the aggregates of the augmentation of all intervals whose low lies in [from, to], in ascending
+         *  order of low. Subtrees that lie in the range as a whole add their kept aggregate, so this takes O(log n).
+         *  Needs hooks with an augmentation, see hooks::with_augmentation.
+         */
+        template <typename augmentation_t = augmentation_type>
+        typename detail::augmentation_value<augmentation_t>::type
+        fold(value_type const& from, value_type const& to) const
+        {
+            static_assert(!std::is_void<augmentation_t>::value, "fold needs hooks with an augmentation.");
+            static_assert(
+                !detail::aggregates_from_node<augmentation_t, node_type>::value,
+                "fold needs an augmentation that combines aggregates."
+            );
+            auto const* node = root_;
+            // Descend to the first node in the range, everything in it lies below this node.
+            while (node)
+            {
+                if (node->low() < from)
+                    node = node->right_ptr();
+                else if (to < node->low())
+                    node = node->left_ptr();
+                else
+                    break;
+            }
+            if (!node)
+                return augmentation_t::identity();
+            return augmentation_t::combine(
+                augmentation_t::combine(fold_from(node->left_ptr(), from), aggregate_of_interval(node)),
+                fold_to(node->right_ptr(), to)
+            );
+        }
+
+        /**
+         *  Combines the aggregates of the augmentation of all intervals, in ascending order of low. Takes O(1).
+         */
+        template <typename augmentation_t = augmentation_type>
+        typename detail::augmentation_value<augmentation_t>::type fold() const
+        {
+            static_assert(!std::is_void<augmentation_t>::value, "fold needs hooks with an augmentation.");
+            static_assert(
+                !detail::aggregates_from_node<augmentation_t, node_type>::value,
+                "fold needs an augmentation that combines aggregates."
+            );
+            return aggregate_of(root_);
+        }
+
+        /**
+         *  Returns an iterator to the interval at position index in ascending order of low, or end() if there is
+         *  none. Needs subtree sizes, see ranked_interval_tree_t. Takes O(log n).
+         */
+        template <typename augmentation_t = augmentation_type>
+        iterator nth(size_type index)
+        {
+            static_assert(detail::is_count_augmentation<augmentation_t>::value, "nth needs subtree sizes.");
+            return {nth_node(index), this};
+        }
+
+        template <typename augmentation_t = augmentation_type>
+        const_iterator nth(size_type index) const
+        {
+            static_assert(detail::is_count_augmentation<augmentation_t>::value, "nth needs subtree sizes.");
+            return {nth_node(index), this};
+        }
+
+        /**
+         *  Returns the position of iter in ascending order of low, size() for end(). The inverse of nth.
+         *  Needs subtree sizes, see ranked_interval_tree_t. Takes O(log n).
+         */
+        template <typename IteratorT, typename augmentation_t = augmentation_type>
+        size_type rank(IteratorT const& iter) const
+        {
+            static_assert(detail::is_count_augmentation<augmentation_t>::value, "rank needs subtree sizes.");
+            node_type const* node = iter.node();
+            if (!node)
+                return size_;
+            auto result = subtree_size(node->left_ptr());
+            for (; node->parent_ptr(); node = node->parent_ptr())
+            {
+                if (node->is_right())
+                    result += subtree_size(node->parent_ptr()->left_ptr()) + 1;
+            }
+            return result;
+        }
+
+        /**
+         *  Returns the amount of intervals whose low is smaller than value, which is the position of the first
+         *  interval with a low of value or larger. Needs subtree sizes, see ranked_interval_tree_t. Takes O(log n).
+         */
+        template <typename augmentation_t = augmentation_type>
+        size_type index_of_low(value_type const& value) const
+        {
+            static_assert(detail::is_count_augmentation<augmentation_t>::value, "index_of_low needs subtree sizes.");
+            size_type result = 0;
+            for (auto const* node = root_; node;)
+            {
+                if (node->low() < value)
+                {
+                    result += subtree_size(node->left_ptr()) + 1;
+                    node = node->right_ptr();
+                }
+                else
+                {
+                    node = node->left_ptr();
+                }
+            }
+            return result;
+        }
+
+        /**
+         *  Returns the iterator count positions after iter (before it, if count is negative), or end() if that
+         *  leaves the tree. Unlike repeated increments this takes O(log n). Needs subtree sizes, see
+         *  ranked_interval_tree_t.
+         */
+        template <typename augmentation_t = augmentation_type>
+        iterator advance(iterator iter, size_type count)
+        {
+            return nth<augmentation_t>(rank<iterator, augmentation_t>(iter) + count);
+        }
+
+        template <typename augmentation_t = augmentation_type>
+        const_iterator advance(const_iterator iter, size_type count) const
+        {
+            return nth<augmentation_t>(rank<const_iterator, augmentation_t>(iter) + count);
+        }
+
+        /**
+         *  Returns how much of window is covered by at least one interval, with lengths as interval::size() has
+         *  them. Needs hooks with augmentations::union_measure. Subtrees that lie past a border of the window add
+         *  their kept union, so this takes two ways down, O(log n).
+         */
+        template <typename augmentation_t = augmentation_type>
+        value_type covered_length(interval_type const& window) const
+        {
+            static_assert(
+                detail::is_union_measure_augmentation<augmentation_t>::value,
+                "covered_length needs hooks with augmentations::union_measure."
+            );
+            const auto span = augmentation_t::from_interval(window);
+            return augmentation_t::covered(static_cast<node_type const*>(root_), span.begin, span.end);
+        }
+
+        /**
+         *  Returns the length of the union of all intervals. Takes O(1).
+         */
+        template <typename augmentation_t = augmentation_type>
+        value_type covered_length() const
+        {
+            static_assert(
+                detail::is_union_measure_augmentation<augmentation_t>::value,
+                "covered_length needs hooks with augmentations::union_measure."
+            );
+            return root_ ? root_->aggregate_.measure : value_type{0};
+        }
+
         /**
          *  Removes all from this tree.
+         *  If the allocator supports it, all nodes are released at once instead of one by one.
+         *  Index linked trees keep their node block for reuse.
          */
         void clear() noexcept
         {
-            clear_subtree(root_);
+            release_nodes(detail::is_index_linked<node_type>{});
             root_ = nullptr;
             size_ = 0;
         }
 
+        /**
+         *  Makes room for at least count nodes. Only has an effect for index linked nodes (see index_links),
+         *  where it saves moving the node block repeatedly while inserting.
+         *  Invalidates all iterators if the block has to grow.
+         */
+        void reserve(size_type count)
+        {
+            storage_.reserve(static_cast<std::size_t>(count), root_);
+        }
+
         /**
          *  Returns the root node from this tree.
          */
@@ -1087,26 +2153,27 @@ namespace lib_interval_tree
         template <typename IntervalType = interval_type>
         iterator insert(IntervalType&& ival)
         {
-            node_type* z = new node_type(nullptr, std::forward<IntervalType&&>(ival));
+            node_type* z = create_node(nullptr, std::forward<IntervalType&&>(ival));
             node_type* y = nullptr;
             node_type* x = root_;
             while (x)
             {
                 y = x;
                 if (z->interval_.low() < x->interval_.low())
-                    x = x->left_;
+                    x = x->left_ptr();
                 else
-                    x = x->right_;
+                    x = x->right_ptr();
             }
-            z->parent_ = y;
+            z->set_parent(y);
             if (!y)
                 root_ = z;
             else if (z->interval_.low() < y->interval_.low())
-                y->left_ = z;
+                y->set_left(z);
             else
-                y->right_ = z;
-            z->color_ = rb_color::red;
+                y->set_right(z);
+            z->set_color(rb_color::red);
 
+            refresh_aggregates_upwards(y, has_augmentation{});
             insert_fixup(z);
             recalculate_max(z);
 
@@ -1152,7 +2219,7 @@ namespace lib_interval_tree
             auto next = iter;
 
             node_type* y = [&next, &iter, this]() {
-                if (!iter.node_->left_ || !iter.node_->right_)
+                if (!iter.node_->left_ptr() || !iter.node_->right_ptr())
                 {
                     ++next;
                     return iter.node_;
@@ -1166,23 +2233,23 @@ namespace lib_interval_tree
             }();
 
             node_type* x = [y]() {
-                if (y->left_)
-                    return y->left_;
+                if (y->left_ptr())
+                    return y->left_ptr();
                 else
-                    return y->right_;
+                    return y->right_ptr();
             }();
 
             if (x)
-                x->parent_ = y->parent_;
+                x->set_parent(y->parent_ptr());
 
-            auto* x_parent = y->parent_;
+            auto* x_parent = y->parent_ptr();
 
-            if (!y->parent_)
+            if (!y->parent_ptr())
                 root_ = x;
             else if (y->is_left())
-                y->parent_->left_ = x;
+                y->parent_ptr()->set_left(x);
             else
-                y->parent_->right_ = x;
+                y->parent_ptr()->set_right(x);
 
             if (y != iter.node_)
             {
@@ -1190,16 +2257,18 @@ namespace lib_interval_tree
                 iter.node_->max_ = y->max_;
                 recalculate_max(iter.node_);
             }
+            // The path from x_parent up passes iter.node_, whose interval may have changed.
+            refresh_aggregates_upwards(x_parent, has_augmentation{});
 
-            if (x && x->color_ == rb_color::red)
+            if (x && x->color() == rb_color::red)
             {
                 if (x_parent)
                     erase_fixup(x, x_parent, y->is_left());
                 else
-                    x->color_ = rb_color::black;
+                    x->set_color(rb_color::black);
             }
 
-            delete y;
+            destroy_node(y);
 
             --size_;
             return next;
@@ -1286,26 +2355,24 @@ namespace lib_interval_tree
         }
 
         /**
-         *  Finds the first exact match.
+         *  Finds the first exact match in order.
+         *  Descends by the low key and only scans the nodes with an equal low, O(log n + equal lows).
          *
          *  @param ival The interval to find an exact match for within the tree.
          */
         iterator find(interval_type const& ival)
         {
-            return find(ival, [](auto const& lhs, auto const& rhs) {
-                return lhs == rhs;
-            });
+            return iterator{find_exact_i(ival), this};
         }
         /**
-         *  Finds the first exact match.
+         *  Finds the first exact match in order.
+         *  Descends by the low key and only scans the nodes with an equal low, O(log n + equal lows).
          *
          *  @param ival The interval to find an exact match for within the tree.
          */
         const_iterator find(interval_type const& ival) const
         {
-            return find(ival, [](auto const& lhs, auto const& rhs) {
-                return lhs == rhs;
-            });
+            return const_iterator{find_exact_i(ival), this};
         }
 
         /**
@@ -1326,19 +2393,18 @@ namespace lib_interval_tree
             find_all_i<this_type, const_iterator>(this, root_, ival, on_find, compare);
         }
 
+        /**
+         *  Finds all exact matches in order, only the nodes with an equal low are scanned.
+         */
         template <typename FunctionT>
         void find_all(interval_type const& ival, FunctionT const& on_find)
         {
-            find_all(ival, on_find, [](auto const& lhs, auto const& rhs) {
-                return lhs == rhs;
-            });
+            find_all_exact_i<this_type, iterator>(this, ival, on_find);
         }
         template <typename FunctionT>
         void find_all(interval_type const& ival, FunctionT const& on_find) const
         {
-            find_all(ival, on_find, [](auto const& lhs, auto const& rhs) {
-                return lhs == rhs;
-            });
+            find_all_exact_i<this_type, const_iterator>(this, ival, on_find);
         }
 
         /**
@@ -1437,20 +2503,162 @@ namespace lib_interval_tree
         }
 
         /**
-         *  Finds the next interval that overlaps with ival
+         *  Runs overlap_find_all for many queries at once. The traversals of up to detail::batch_width queries are
+         *  interleaved and the children of a node are prefetched before the other queries take their turn,
+         *  so the cache misses of one query overlap with the work of the others.
          *
-         *  @param from The iterator to start from, EXCLUSIVE!
-         *  @param ival The interval to find an overlap for within the tree.
+         *  @param queries A random access container of interval_type, like std::vector.
+         *  @param on_find A function of type bool(std::size_t query_index, iterator) that is called when an interval
+         *  was found. Return false to stop the search for this query only. Results of different queries interleave.
          *  @param exclusive Exclude edges?
          */
-        iterator overlap_find_next_in_subtree(iterator from, interval_type const& ival, bool exclusive = false)
+        template <typename QueriesT, typename FunctionT>
+        void overlap_find_batch(QueriesT const& queries, FunctionT const& on_find, bool exclusive = false)
         {
             if (root_ == nullptr)
-                return end();
-            return iterator{overlap_find_i_ex(from.node_, ival, exclusive), this};
+                return;
+            if (exclusive)
+                overlap_find_batch_i<this_type, true, iterator>(this, queries, on_find);
+            else
+                overlap_find_batch_i<this_type, false, iterator>(this, queries, on_find);
         }
-        const_iterator
-        overlap_find_next_in_subtree(const_iterator from, interval_type const& ival, bool exclusive = false) const
+        template <typename QueriesT, typename FunctionT>
+        void overlap_find_batch(QueriesT const& queries, FunctionT const& on_find, bool exclusive = false) const
+        {
+            if (root_ == nullptr)
+                return;
+            if (exclusive)
+                overlap_find_batch_i<this_type, true, const_iterator>(this, queries, on_find);
+            else
+                overlap_find_batch_i<this_type, false, const_iterator>(this, queries, on_find);
+        }
+
+        /**
+         *  Runs overlap_find_all for many queries in a single traversal of the tree.
+         *  The queries are sorted by low and walk down together, at every node the set of queries is split by the
+         *  max of the children and the key order. Paths that queries share are only walked once.
+         *  Best suited for many queries that lie close to each other.
+         *
+         *  @param queries A random access container of interval_type, like std::vector. Does not need to be sorted.
+         *  @param on_find A function of type bool(std::size_t query_index, iterator) that is called when an interval
+         *  was found. Return false to stop the search for this query only. Results of different queries interleave.
+         *  @param exclusive Exclude edges?
+         */
+        template <typename QueriesT, typename FunctionT>
+        void overlap_find_batch_sorted(QueriesT const& queries, FunctionT const& on_find, bool exclusive = false)
+        {
+            if (root_ == nullptr)
+                return;
+            if (exclusive)
+                overlap_find_batch_sorted_i<this_type, true, iterator>(this, queries, on_find);
+            else
+                overlap_find_batch_sorted_i<this_type, false, iterator>(this, queries, on_find);
+        }
+        template <typename QueriesT, typename FunctionT>
+        void overlap_find_batch_sorted(QueriesT const& queries, FunctionT const& on_find, bool exclusive = false) const
+        {
+            if (root_ == nullptr)
+                return;
+            if (exclusive)
+                overlap_find_batch_sorted_i<this_type, true, const_iterator>(this, queries, on_find);
+            else
+                overlap_find_batch_sorted_i<this_type, false, const_iterator>(this, queries, on_find);
+        }
+
+        /**
+         *  Finds all pairs (a, b) of an interval a of this tree and an interval b of other, where a overlaps b.
+         *  Both trees are walked together. A pair of subtrees is skipped if the max of one cannot reach the lowest
+         *  low that the key order allows in the other.
+         *
+         *  @param other The tree to join with.
+         *  @param on_pair A function of type bool(const_iterator a, const_iterator b). Return false to stop.
+         *  @param exclusive Exclude edges?
+         */
+        template <typename FunctionT>
+        void overlap_join(interval_tree const& other, FunctionT const& on_pair, bool exclusive = false) const
+        {
+            if (root_ == nullptr || other.root_ == nullptr)
+                return;
+            if (exclusive)
+                overlap_join_i<true>(other, {root_, nullptr}, {other.root_, nullptr}, on_pair);
+            else
+                overlap_join_i<false>(other, {root_, nullptr}, {other.root_, nullptr}, on_pair);
+        }
+
+        /**
+         *  Calls on_pair(a, b) once for every unordered pair of intervals in this tree that overlap. a is the one
+         *  that comes first in iteration order and the pair is tested as a.overlaps(b). The tree is swept once in
+         *  order, keeping only the intervals that later ones can still reach.
+         *
+         *  @param on_pair A function of type bool(const_iterator a, const_iterator b). Return false to stop.
+         *  @param exclusive Exclude edges?
+         */
+        template <typename FunctionT>
+        void for_each_overlapping_pair(FunctionT const& on_pair, bool exclusive = false) const
+        {
+            if (root_ == nullptr)
+                return;
+            if (exclusive)
+                for_each_overlapping_pair_i<true>(on_pair);
+            else
+                for_each_overlapping_pair_i<false>(on_pair);
+        }
+
+        /**
+         *  Calls on_find for every interval that contains value, as decided by interval_type::within.
+         *  Unlike overlap_find_all with {value, value}, this also works for kinds where such an interval is empty.
+         *
+         *  @param value The point to stab the tree with.
+         *  @param on_find A function of type bool(iterator). Return false to stop the search.
+         */
+        template <typename FunctionT>
+        void stab(value_type const& value, FunctionT const& on_find)
+        {
+            if (root_ == nullptr)
+                return;
+            stab_i<this_type, iterator>(this, root_, value, on_find);
+        }
+        template <typename FunctionT>
+        void stab(value_type const& value, FunctionT const& on_find) const
+        {
+            if (root_ == nullptr)
+                return;
+            stab_i<this_type, const_iterator>(this, root_, value, on_find);
+        }
+
+        /**
+         *  Finds the first interval in order that contains value.
+         *
+         *  @param value The point to stab the tree with.
+         */
+        iterator stab_first(value_type const& value)
+        {
+            if (root_ == nullptr)
+                return end();
+            return iterator{stab_first_i(root_, value), this};
+        }
+        const_iterator stab_first(value_type const& value) const
+        {
+            if (root_ == nullptr)
+                return end();
+            return const_iterator{stab_first_i(root_, value), this};
+        }
+
+        /**
+         *  Finds the next interval that overlaps with ival
+         *
+         *  @param from The iterator to start from, EXCLUSIVE!
+         *  @param ival The interval to find an overlap for within the tree.
+         *  @param exclusive Exclude edges?
+         */
+        iterator overlap_find_next_in_subtree(iterator from, interval_type const& ival, bool exclusive = false)
+        {
+            if (root_ == nullptr)
+                return end();
+            return iterator{overlap_find_i_ex(from.node_, ival, exclusive), this};
+        }
+        const_iterator
+        overlap_find_next_in_subtree(const_iterator from, interval_type const& ival, bool exclusive = false) const
         {
             if (root_ == nullptr)
                 return end();
@@ -1462,7 +2670,7 @@ namespace lib_interval_tree
          */
         interval_tree deoverlap_copy()
         {
-            interval_tree fresh;
+            interval_tree fresh{get_allocator()};
             for (auto i = begin(), e = end(); i != e; ++i)
                 fresh.insert_overlap(*i);
 
@@ -1485,7 +2693,7 @@ namespace lib_interval_tree
         interval_tree punch() const
         {
             if (empty())
-                return {};
+                return interval_tree{get_allocator()};
             return punch({begin()->low(), root_->max_});
         }
 
@@ -1505,7 +2713,7 @@ namespace lib_interval_tree
 #endif
         punch(interval_type ival) const
         {
-            interval_tree result;
+            interval_tree result{get_allocator()};
 
             if (empty())
             {
@@ -1565,8 +2773,8 @@ namespace lib_interval_tree
 
             auto* iter = root_;
 
-            while (iter->left_)
-                iter = iter->left_;
+            while (iter->left_ptr())
+                iter = iter->left_ptr();
 
             return {iter, this};
         }
@@ -1582,8 +2790,8 @@ namespace lib_interval_tree
 
             auto* iter = root_;
 
-            while (iter->right_)
-                iter = iter->right_;
+            while (iter->right_ptr())
+                iter = iter->right_ptr();
 
             return {iter, this};
         }
@@ -1599,8 +2807,8 @@ namespace lib_interval_tree
 
             auto* iter = root_;
 
-            while (iter->left_)
-                iter = iter->left_;
+            while (iter->left_ptr())
+                iter = iter->left_ptr();
 
             return const_iterator{iter, this};
         }
@@ -1624,8 +2832,8 @@ namespace lib_interval_tree
 
             auto* iter = root_;
 
-            while (iter->right_)
-                iter = iter->right_;
+            while (iter->right_ptr())
+                iter = iter->right_ptr();
 
             return const_reverse_iterator{iter, this};
         }
@@ -1678,15 +2886,15 @@ namespace lib_interval_tree
                 go_right = search_value > node->high();
                 if (go_right)
                 {
-                    go_right &= node->right_ != nullptr;
+                    go_right &= node->right_ptr() != nullptr;
                     if (go_right)
-                        node = node->right_;
+                        node = node->right_ptr();
                     continue;
                 }
 
-                go_left = node->left_ != nullptr && search_value < node->low();
+                go_left = node->left_ptr() != nullptr && search_value < node->low();
                 if (go_left)
-                    node = node->left_;
+                    node = node->left_ptr();
             } while (go_left || go_right);
 
             if (search_value < node->low())
@@ -1695,15 +2903,114 @@ namespace lib_interval_tree
             return node;
         }
 
+        static bool low_less(interval_type const& lhs, interval_type const& rhs)
+        {
+            return lhs.low() < rhs.low();
+        }
+
+        /**
+         *  A balanced split leaves all leaves on the last two levels. Coloring the last level red, unless it
+         *  is full, gives every path the same amount of black nodes. Returns that depth, or -1 for none.
+         */
+        static int balanced_red_depth(size_type count)
+        {
+            int levels = 0;
+            for (auto remaining = count; remaining != 0; remaining /= 2)
+                ++levels;
+            const bool last_level_full = count == (size_type{1} << levels) - 1;
+            return last_level_full ? -1 : levels - 1;
+        }
+
+        /**
+         *  Relinking all nodes costs about one visit per node, inserting one by one a descent and fixup per
+         *  interval.
+         */
+        bool rebuild_pays_off(size_type batch_size) const
+        {
+            int levels = 0;
+            for (auto remaining = size_ + batch_size; remaining != 0; remaining /= 2)
+                ++levels;
+            return batch_size * levels >= size_;
+        }
+
+        /**
+         *  Links up a subtree and computes its max, the children must be complete already.
+         */
+        static void link_subtree(node_type* node, node_type* left, node_type* right, int depth, int red_depth)
+        {
+            node->set_color(depth == red_depth ? rb_color::red : rb_color::black);
+            node->set_left(left);
+            node->set_right(right);
+            node->max_ = node->interval_.high();
+            if (left)
+            {
+                left->set_parent(node);
+                node->max_ = std::max(node->max_, left->max_);
+            }
+            if (right)
+            {
+                right->set_parent(node);
+                node->max_ = std::max(node->max_, right->max_);
+            }
+            refresh_aggregate(node, has_augmentation{});
+        }
+
+        /**
+         *  Links count nodes, sorted by low, into a balanced subtree.
+         */
+        static node_type* link_balanced(node_type* const* nodes, size_type count, int depth, int red_depth)
+        {
+            if (count == 0)
+                return nullptr;
+
+            const size_type left_count = count / 2;
+            node_type* left = link_balanced(nodes, left_count, depth + 1, red_depth);
+            node_type* right = link_balanced(nodes + left_count + 1, count - 1 - left_count, depth + 1, red_depth);
+            link_subtree(nodes[left_count], left, right, depth, red_depth);
+            return nodes[left_count];
+        }
+
+        /**
+         *  Builds a balanced subtree from the next count intervals of iter, in order.
+         */
+        template <typename ForwardIteratorT>
+        node_type* build_balanced(ForwardIteratorT& iter, size_type count, int depth, int red_depth)
+        {
+            if (count == 0)
+                return nullptr;
+
+            const size_type left_count = count / 2;
+            node_type* left = build_balanced(iter, left_count, depth + 1, red_depth);
+            node_type* node = nullptr;
+            node_type* right = nullptr;
+            try
+            {
+                node = create_node(nullptr, *iter);
+                ++iter;
+                right = build_balanced(iter, count - 1 - left_count, depth + 1, red_depth);
+            }
+            catch (...)
+            {
+                clear_subtree(left);
+                if (node)
+                    destroy_node(node);
+                throw;
+            }
+
+            link_subtree(node, left, right, depth, red_depth);
+            return node;
+        }
+
         node_type* copy_tree_impl(node_type* root, node_type* parent)
         {
             if (root)
             {
-                auto* cpy = new node_type(parent, *root->interval());
-                cpy->color_ = root->color_;
+                auto* cpy = create_node(parent, *root->interval());
+                cpy->set_color(root->color());
                 cpy->max_ = root->max_;
-                cpy->left_ = copy_tree_impl(root->left_, cpy);
-                cpy->right_ = copy_tree_impl(root->right_, cpy);
+                cpy->set_left(copy_tree_impl(root->left_ptr(), cpy));
+                cpy->set_right(copy_tree_impl(root->right_ptr(), cpy));
+                refresh_aggregate(cpy, has_augmentation{});
                 return cpy;
             }
             return nullptr;
@@ -1750,12 +3057,153 @@ namespace lib_interval_tree
         {
             if (node)
             {
-                clear_subtree(node->left_);
-                clear_subtree(node->right_);
-                delete node;
+                clear_subtree(node->left_ptr());
+                clear_subtree(node->right_ptr());
+                destroy_node(node);
+            }
+        }
+
+        void release_nodes(std::true_type /*index_linked*/) noexcept
+        {
+            storage_.reset();
+        }
+
+        void release_nodes(std::false_type /*index_linked*/) noexcept
+        {
+            release_allocated_nodes(detail::has_bulk_release<node_allocator_type>{});
+        }
+
+        void release_allocated_nodes(std::false_type) noexcept
+        {
+            clear_subtree(root_);
+        }
+
+        void release_allocated_nodes(std::true_type) noexcept
+        {
+            if (!storage_.allocator().can_release_all())
+            {
+                clear_subtree(root_);
+                return;
+            }
+            destroy_subtree(root_, std::is_trivially_destructible<node_type>{});
+            storage_.allocator().release_all();
+        }
+
+        void destroy_subtree(node_type*, std::true_type) noexcept
+        {}
+
+        /**
+         *  Runs the destructors only, the memory is released in bulk afterwards.
+         */
+        void destroy_subtree(node_type* node, std::false_type) noexcept
+        {
+            if (node)
+            {
+                destroy_subtree(node->left_ptr(), std::false_type{});
+                destroy_subtree(node->right_ptr(), std::false_type{});
+                node_allocator_traits::destroy(storage_.allocator(), node);
+            }
+        }
+
+        /**
+         *  Creates a node, note that this might move all nodes of index linked trees.
+         *  root_ stays valid, other node pointers do not.
+         */
+        template <typename... Args>
+        node_type* create_node(Args&&... args)
+        {
+            node_type* memory = storage_.allocate(root_);
+            try
+            {
+                node_allocator_traits::construct(storage_.allocator(), memory, std::forward<Args>(args)...);
+            }
+            catch (...)
+            {
+                storage_.deallocate(memory);
+                throw;
+            }
+            return memory;
+        }
+
+        void destroy_node(node_type* node) noexcept
+        {
+            node_allocator_traits::destroy(storage_.allocator(), node);
+            storage_.deallocate(node);
+        }
+
+        void propagate_allocator(node_allocator_type const& allocator, std::true_type)
+        {
+            // The node block of index linked trees must go back to the allocator it came from.
+            storage_.release();
+            storage_.allocator() = allocator;
+        }
+
+        void propagate_allocator(node_allocator_type const&, std::false_type)
+        {}
+
+        void propagate_allocator(node_allocator_type&& allocator, std::true_type) noexcept
+        {
+            storage_.release();
+            storage_.allocator() = std::move(allocator);
+        }
+
+        void propagate_allocator(node_allocator_type&&, std::false_type) noexcept
+        {}
+
+        /**
+         *  Gives a tree whose allocator was moved away a fresh one, the same a copy of this tree would get.
+         *  Otherwise both trees would share allocator state and neither could release its nodes in bulk.
+         */
+        void renew_allocator(interval_tree& other) noexcept
+        {
+            try
+            {
+                other.storage_.allocator() =
+                    node_allocator_traits::select_on_container_copy_construction(storage_.allocator());
+            }
+            catch (...)
+            {
+                // Sharing the allocator is still correct, only bulk release is lost.
+                other.storage_.allocator() = storage_.allocator();
             }
         }
 
+        /**
+         *  Takes over the nodes of other, only valid if both allocators compare equal.
+         */
+        void steal(interval_tree& other) noexcept
+        {
+            storage_.take(other.storage_);
+            root_ = other.root_;
+            size_ = other.size_;
+            other.root_ = nullptr;
+            other.size_ = 0;
+        }
+
+        /**
+         *  Element wise move for unequal allocators, nodes of other cannot be released by ours.
+         */
+        void copy_and_clear(interval_tree& other)
+        {
+            copy_nodes(other, detail::is_index_linked<node_type>{});
+            size_ = other.size_;
+            other.clear();
+        }
+
+        void copy_nodes(interval_tree const& other, std::false_type /*index_linked*/)
+        {
+            if (other.root_ != nullptr)
+                root_ = copy_tree_impl(other.root_, nullptr);
+        }
+
+        /**
+         *  Index linked nodes only point relative to each other, so the whole block is copied at once.
+         */
+        void copy_nodes(interval_tree const& other, std::true_type /*index_linked*/)
+        {
+            root_ = storage_.copy(other.storage_, other.root_);
+        }
+
         template <typename ThisType, typename IteratorT, typename FunctionT, typename ComparatorFunctionT>
         static bool find_all_i(
             typename std::conditional<std::is_same<IteratorT, iterator>::value, ThisType, ThisType const>::type* self,
@@ -1771,18 +3219,80 @@ namespace lib_interval_tree
                 if (!on_find(IteratorT{ptr, self}))
                     return false;
             }
-            if (ptr->left_ && ival.high() <= ptr->left_->max())
+            if (ptr->left_ptr() && ival.high() <= ptr->left_ptr()->max())
             {
-                if (!find_all_i<ThisType, IteratorT>(self, ptr->left_, ival, on_find, compare))
+                if (!find_all_i<ThisType, IteratorT>(self, ptr->left_ptr(), ival, on_find, compare))
                     return false;
             }
-            if (ptr->right_ && ival.high() <= ptr->right_->max())
+            if (ptr->right_ptr() && ival.high() <= ptr->right_ptr()->max())
             {
-                return find_all_i<ThisType, IteratorT>(self, ptr->right_, ival, on_find, compare);
+                return find_all_i<ThisType, IteratorT>(self, ptr->right_ptr(), ival, on_find, compare);
             }
             return true;
         }
 
+        /**
+         *  Returns the first node in order whose low is not less than the given one.
+         *  Nodes with an equal low can end up on both sides through rotations, so the descent does not stop on them.
+         */
+        template <typename VisitFunctionT>
+        node_type* lower_bound_i(value_type const& low, VisitFunctionT const& visit) const
+        {
+            node_type* result = nullptr;
+            for (auto* ptr = root_; ptr != nullptr;)
+            {
+                visit(ptr);
+                if (ptr->low() < low)
+                {
+                    ptr = ptr->right_ptr();
+                }
+                else
+                {
+                    result = ptr;
+                    ptr = ptr->left_ptr();
+                }
+            }
+            return result;
+        }
+
+        node_type* find_exact_i(interval_type const& ival) const
+        {
+            const auto compare = [](auto const& lhs, auto const& rhs) {
+                return lhs == rhs;
+            };
+            const auto visit = [this, &ival, &compare](node_type* ptr) {
+                tree_hooks::template on_find<this_type>(*this, ptr, ival, compare);
+            };
+            for (auto* ptr = lower_bound_i(ival.low(), visit); ptr != nullptr && !(ival.low() < ptr->low());
+                 ptr = successor(ptr))
+            {
+                if (compare(*ptr->interval(), ival))
+                    return ptr;
+            }
+            return nullptr;
+        }
+
+        template <typename ThisType, typename IteratorT, typename FunctionT>
+        static void find_all_exact_i(
+            typename std::conditional<std::is_same<IteratorT, iterator>::value, ThisType, ThisType const>::type* self,
+            interval_type const& ival,
+            FunctionT const& on_find
+        )
+        {
+            const auto compare = [](auto const& lhs, auto const& rhs) {
+                return lhs == rhs;
+            };
+            const auto visit = [self, &ival, &compare](node_type* ptr) {
+                std::decay_t<ThisType>::tree_hooks_type::template on_find_all<this_type>(*self, ptr, ival, compare);
+            };
+            for (auto* ptr = self->lower_bound_i(ival.low(), visit); ptr != nullptr && !(ival.low() < ptr->low());
+                 ptr = self->successor(ptr))
+            {
+                if (compare(*ptr->interval(), ival) && !on_find(IteratorT{ptr, self}))
+                    return;
+            }
+        }
+
         template <typename ComparatorFunctionT>
         node_type* find_i(node_type* ptr, interval_type const& ival, ComparatorFunctionT const& compare) const
         {
@@ -1797,15 +3307,15 @@ namespace lib_interval_tree
         template <typename ComparatorFunctionT>
         node_type* find_i_ex(node_type* ptr, interval_type const& ival, ComparatorFunctionT const& compare) const
         {
-            if (ptr->left_ && ival.high() <= ptr->left_->max())
+            if (ptr->left_ptr() && ival.high() <= ptr->left_ptr()->max())
             {
-                auto* res = find_i(ptr->left_, ival, compare);
+                auto* res = find_i(ptr->left_ptr(), ival, compare);
                 if (res != nullptr)
                     return res;
             }
-            if (ptr->right_ && ival.high() <= ptr->right_->max())
+            if (ptr->right_ptr() && ival.high() <= ptr->right_ptr()->max())
             {
-                return find_i(ptr->right_, ival, compare);
+                return find_i(ptr->right_ptr(), ival, compare);
             }
             return nullptr;
         }
@@ -1865,44 +3375,438 @@ namespace lib_interval_tree
                     }
                 }
             }
-            if (ptr->left_ && ptr->left_->max() >= ival.low())
+            using bounds = detail::overlap_bounds<interval_type>;
+            if (ptr->left_ptr() && bounds::high_reaches(ptr->left_ptr()->max(), ival))
             {
-                if (!overlap_find_all_i<ThisType, Exclusive, IteratorT>(self, ptr->left_, ival, on_find))
+                if (!overlap_find_all_i<ThisType, Exclusive, IteratorT>(self, ptr->left_ptr(), ival, on_find))
                     return false;
             }
-            if (ptr->right_ && ptr->right_->max() >= ival.low())
+            // Everything right of ptr starts at ptr->low() or later.
+            if (ptr->right_ptr() && bounds::low_reaches(ptr->low(), ival) &&
+                bounds::high_reaches(ptr->right_ptr()->max(), ival))
             {
-                return overlap_find_all_i<ThisType, Exclusive, IteratorT>(self, ptr->right_, ival, on_find);
+                return overlap_find_all_i<ThisType, Exclusive, IteratorT>(self, ptr->right_ptr(), ival, on_find);
             }
             return true;
         }
 
+        /**
+         *  Every query owns a stack of nodes that are prefetched but not yet looked at. The slots take turns,
+         *  each turn pops one node, so a prefetch has the turns of all other slots to arrive.
+         *  The max of a node is checked when it is popped and not when it is pushed, to not touch it early.
+         */
+        template <typename ThisType, bool Exclusive, typename IteratorT, typename QueriesT, typename FunctionT>
+        static void overlap_find_batch_i(
+            typename std::conditional<std::is_same<IteratorT, iterator>::value, ThisType, ThisType const>::type* self,
+            QueriesT const& queries,
+            FunctionT const& on_find
+        )
+        {
+            using bounds = detail::overlap_bounds<interval_type>;
+            struct slot
+            {
+                std::size_t query;
+                std::vector<node_type*> stack;
+            };
+
+            const std::size_t query_count = queries.size();
+            std::vector<slot> slots(std::min(query_count, detail::batch_width));
+            std::size_t next_query = 0;
+            for (auto& current : slots)
+            {
+                current.query = next_query++;
+                current.stack.push_back(self->root_);
+            }
+            detail::prefetch(self->root_);
+
+            std::size_t active = slots.size();
+            while (active != 0)
+            {
+                for (auto& current : slots)
+                {
+                    if (current.stack.empty())
+                    {
+                        if (current.query == query_count)
+                            continue;
+                        if (next_query == query_count)
+                        {
+                            current.query = query_count;
+                            --active;
+                            continue;
+                        }
+                        current.query = next_query++;
+                        current.stack.push_back(self->root_);
+                    }
+
+                    auto* ptr = current.stack.back();
+                    current.stack.pop_back();
+                    interval_type const& ival = queries[current.query];
+                    if (!bounds::high_reaches(ptr->max(), ival))
+                        continue;
+
+                    std::decay_t<ThisType>::tree_hooks_type::template on_overlap_find_all<ThisType>(*self, ptr, ival);
+                    bool found;
+#if __cplusplus >= 201703L
+                    if constexpr (Exclusive)
+#else
+                    if (Exclusive)
+#endif
+                        found = ptr->interval()->overlaps_exclusive(ival);
+                    else
+                        found = ptr->interval()->overlaps(ival);
+                    if (found && !on_find(current.query, IteratorT{ptr, self}))
+                    {
+                        current.stack.clear();
+                        continue;
+                    }
+
+                    if (ptr->right_ptr() && bounds::low_reaches(ptr->low(), ival))
+                    {
+                        detail::prefetch(ptr->right_ptr());
+                        current.stack.push_back(ptr->right_ptr());
+                    }
+                    if (ptr->left_ptr())
+                    {
+                        detail::prefetch(ptr->left_ptr());
+                        current.stack.push_back(ptr->left_ptr());
+                    }
+                }
+            }
+        }
+
+        template <typename ThisType, bool Exclusive, typename IteratorT, typename QueriesT, typename FunctionT>
+        static void overlap_find_batch_sorted_i(
+            typename std::conditional<std::is_same<IteratorT, iterator>::value, ThisType, ThisType const>::type* self,
+            QueriesT const& queries,
+            FunctionT const& on_find
+        )
+        {
+            std::vector<std::size_t> active(queries.size());
+            for (std::size_t i = 0; i != active.size(); ++i)
+                active[i] = i;
+            std::stable_sort(active.begin(), active.end(), [&queries](std::size_t lhs, std::size_t rhs) {
+                return queries[lhs].low() < queries[rhs].low();
+            });
+            std::vector<char> stopped(queries.size(), 0);
+
+            const auto reaching = reaching_prefix(active.begin(), active.end(), self->root_->max(), queries);
+            if (reaching != 0)
+            {
+                overlap_find_batch_sorted_i<ThisType, Exclusive, IteratorT>(
+                    self, self->root_, queries, active, 0, reaching, stopped, on_find
+                );
+            }
+        }
+
+        /**
+         *  Returns how many of the queries, sorted by low, reach max.
+         */
+        template <typename IndexIteratorT, typename QueriesT>
+        static std::size_t
+        reaching_prefix(IndexIteratorT first, IndexIteratorT last, value_type const& max, QueriesT const& queries)
+        {
+            using bounds = detail::overlap_bounds<interval_type>;
+            return static_cast<std::size_t>(
+                std::partition_point(
+                    first,
+                    last,
+                    [&max, &queries](std::size_t query) {
+                        return bounds::high_reaches(max, queries[query]);
+                    }
+                ) -
+                first
+            );
+        }
+
+        /**
+         *  active[first, last) are the queries that reach the max of ptr, sorted by low.
+         *  The queries for the left child are a prefix of them, because reaching a max only depends on the low.
+         *  The queries for the right child also depend on their high, so they are copied to the end of active.
+         */
+        template <typename ThisType, bool Exclusive, typename IteratorT, typename QueriesT, typename FunctionT>
+        static void overlap_find_batch_sorted_i(
+            typename std::conditional<std::is_same<IteratorT, iterator>::value, ThisType, ThisType const>::type* self,
+            node_type* ptr,
+            QueriesT const& queries,
+            std::vector<std::size_t>& active,
+            std::size_t first,
+            std::size_t last,
+            std::vector<char>& stopped,
+            FunctionT const& on_find
+        )
+        {
+            using bounds = detail::overlap_bounds<interval_type>;
+            for (auto i = first; i != last; ++i)
+            {
+                const auto query = active[i];
+                if (stopped[query])
+                    continue;
+                interval_type const& ival = queries[query];
+                std::decay_t<ThisType>::tree_hooks_type::template on_overlap_find_all<ThisType>(*self, ptr, ival);
+                bool found;
+#if __cplusplus >= 201703L
+                if constexpr (Exclusive)
+#else
+                if (Exclusive)
+#endif
+                    found = ptr->interval()->overlaps_exclusive(ival);
+                else
+                    found = ptr->interval()->overlaps(ival);
+                if (found && !on_find(query, IteratorT{ptr, self}))
+                    stopped[query] = 1;
+            }
+
+            if (ptr->left_ptr())
+            {
+                const auto reaching =
+                    reaching_prefix(active.begin() + first, active.begin() + last, ptr->left_ptr()->max(), queries);
+                if (reaching != 0)
+                {
+                    overlap_find_batch_sorted_i<ThisType, Exclusive, IteratorT>(
+                        self, ptr->left_ptr(), queries, active, first, first + reaching, stopped, on_find
+                    );
+                }
+            }
+            if (ptr->right_ptr())
+            {
+                const auto begin = active.size();
+                const auto max = ptr->right_ptr()->max();
+                for (auto i = first; i != last; ++i)
+                {
+                    const auto query = active[i];
+                    if (!stopped[query] && bounds::low_reaches(ptr->low(), queries[query]) &&
+                        bounds::high_reaches(max, queries[query]))
+                    {
+                        active.push_back(query);
+                    }
+                }
+                if (active.size() != begin)
+                {
+                    overlap_find_batch_sorted_i<ThisType, Exclusive, IteratorT>(
+                        self, ptr->right_ptr(), queries, active, begin, active.size(), stopped, on_find
+                    );
+                }
+                active.resize(begin);
+            }
+        }
+
+        /**
+         *  A subtree taking part in a join and the node whose low is a lower bound for all lows in it.
+         *  floor is nullptr if no such bound is known.
+         */
+        struct join_subtree
+        {
+            node_type* node;
+            node_type* floor;
+        };
+
+        template <bool Exclusive>
+        static bool join_overlaps(interval_type const& lhs, interval_type const& rhs)
+        {
+#if __cplusplus >= 201703L
+            if constexpr (Exclusive)
+#else
+            if (Exclusive)
+#endif
+                return lhs.overlaps_exclusive(rhs);
+            else
+                return lhs.overlaps(rhs);
+        }
+
+        template <bool Exclusive, typename FunctionT>
+        void for_each_overlapping_pair_i(FunctionT const& on_pair) const
+        {
+            using bounds = detail::overlap_bounds<interval_type>;
+            std::vector<node_type*> active;
+            for (auto* node = minimum(root_); node != nullptr; node = successor(node))
+            {
+                // All lows from here on are at least node->low(), an interval whose high does not reach it is done.
+                for (std::size_t i = 0; i < active.size();)
+                {
+                    auto* earlier = active[i];
+                    if (!bounds::high_reaches_low(earlier->high(), node->low()))
+                    {
+                        active[i] = active.back();
+                        active.pop_back();
+                        continue;
+                    }
+                    if (join_overlaps<Exclusive>(*earlier->interval(), *node->interval()) &&
+                        !on_pair(const_iterator{earlier, this}, const_iterator{node, this}))
+                    {
+                        return;
+                    }
+                    ++i;
+                }
+                active.push_back(node);
+            }
+        }
+
+        /**
+         *  Reports the pairs of lhs x rhs that involve the root of lhs or the root of rhs and hands the four pairs
+         *  of children to on_children, which together cover the remaining pairs.
+         */
+        template <bool Exclusive, typename FunctionT, typename ChildrenFunctionT>
+        bool overlap_join_step(
+            interval_tree const& other,
+            join_subtree lhs,
+            join_subtree rhs,
+            FunctionT const& on_pair,
+            ChildrenFunctionT const& on_children
+        ) const
+        {
+            using bounds = detail::overlap_bounds<interval_type>;
+            auto* x = lhs.node;
+            auto* y = rhs.node;
+            if (rhs.floor != nullptr && !bounds::high_reaches_low(x->max(), rhs.floor->low()))
+                return true;
+            if (lhs.floor != nullptr && !bounds::low_reaches_high(lhs.floor->low(), y->max()))
+                return true;
+
+            if (!overlap_join_node_i<Exclusive>(other, x, y, on_pair))
+                return false;
+
+            interval_type const& ival = *y->interval();
+            const auto with_y = [this, &other, y, &on_pair](const_iterator a) {
+                return on_pair(a, const_iterator{y, &other});
+            };
+            if (x->left_ptr() && bounds::high_reaches(x->left_ptr()->max(), ival))
+            {
+                if (!overlap_find_all_i<this_type, Exclusive, const_iterator>(this, x->left_ptr(), ival, with_y))
+                    return false;
+            }
+            if (x->right_ptr() && bounds::low_reaches(x->low(), ival) &&
+                bounds::high_reaches(x->right_ptr()->max(), ival))
+            {
+                if (!overlap_find_all_i<this_type, Exclusive, const_iterator>(this, x->right_ptr(), ival, with_y))
+                    return false;
+            }
+
+            const join_subtree lhs_children[] = {{x->left_ptr(), lhs.floor}, {x->right_ptr(), x}};
+            const join_subtree rhs_children[] = {{y->left_ptr(), rhs.floor}, {y->right_ptr(), y}};
+            for (auto const& lhs_child : lhs_children)
+            {
+                if (lhs_child.node == nullptr)
+                    continue;
+                for (auto const& rhs_child : rhs_children)
+                {
+                    if (rhs_child.node != nullptr && !on_children(lhs_child, rhs_child))
+                        return false;
+                }
+            }
+            return true;
+        }
+
+        template <bool Exclusive, typename FunctionT>
+        bool overlap_join_i(interval_tree const& other, join_subtree lhs, join_subtree rhs, FunctionT const& on_pair)
+            const
+        {
+            return overlap_join_step<Exclusive>(
+                other,
+                lhs,
+                rhs,
+                on_pair,
+                [this, &other, &on_pair](join_subtree lhs_child, join_subtree rhs_child) {
+                    return overlap_join_i<Exclusive>(other, lhs_child, rhs_child, on_pair);
+                }
+            );
+        }
+
+        /**
+         *  Reports the intervals of the subtree ptr of other that the interval of a overlaps.
+         */
+        template <bool Exclusive, typename FunctionT>
+        bool overlap_join_node_i(interval_tree const& other, node_type* a, node_type* ptr, FunctionT const& on_pair)
+            const
+        {
+            using bounds = detail::overlap_bounds<interval_type>;
+            interval_type const& ival = *a->interval();
+            if (!bounds::low_reaches_high(ival.low(), ptr->max()))
+                return true;
+            if (join_overlaps<Exclusive>(ival, *ptr->interval()) &&
+                !on_pair(const_iterator{a, this}, const_iterator{ptr, &other}))
+            {
+                return false;
+            }
+            if (ptr->left_ptr() && !overlap_join_node_i<Exclusive>(other, a, ptr->left_ptr(), on_pair))
+                return false;
+            // Everything right of ptr starts at ptr->low() or later.
+            if (ptr->right_ptr() && bounds::high_reaches_low(ival.high(), ptr->low()))
+                return overlap_join_node_i<Exclusive>(other, a, ptr->right_ptr(), on_pair);
+            return true;
+        }
+
         // excludes ptr
         template <bool Exclusive>
         node_type* overlap_find_i_ex(node_type* ptr, interval_type const& ival) const
         {
-            if (ptr->left_ && ptr->left_->max() >= ival.low())
+            using bounds = detail::overlap_bounds<interval_type>;
+            if (ptr->left_ptr() && bounds::high_reaches(ptr->left_ptr()->max(), ival))
             {
-                auto* res = overlap_find_i<Exclusive>(ptr->left_, ival);
+                auto* res = overlap_find_i<Exclusive>(ptr->left_ptr(), ival);
                 if (res != nullptr)
                     return res;
             }
-            if (ptr->right_ && ptr->right_->max() >= ival.low())
+            if (ptr->right_ptr() && bounds::low_reaches(ptr->low(), ival) &&
+                bounds::high_reaches(ptr->right_ptr()->max(), ival))
+            {
+                return overlap_find_i<Exclusive>(ptr->right_ptr(), ival);
+            }
+            return nullptr;
+        }
+
+        /**
+         *  Point searches prune with non strict bounds, within() has the final say for every kind.
+         *  Once a low lies beyond value, so does everything right of it.
+         */
+        template <typename ThisType, typename IteratorT, typename FunctionT>
+        static bool stab_i(
+            typename std::conditional<std::is_same<IteratorT, iterator>::value, ThisType, ThisType const>::type* self,
+            node_type* ptr,
+            value_type const& value,
+            FunctionT const& on_find
+        )
+        {
+            std::decay_t<ThisType>::tree_hooks_type::template on_stab<this_type>(*self, ptr, value);
+            const bool right_reaches = !(value < ptr->low());
+            if (right_reaches && ptr->interval()->within(value) && !on_find(IteratorT{ptr, self}))
+                return false;
+            if (ptr->left_ptr() && !(ptr->left_ptr()->max() < value))
+            {
+                if (!stab_i<ThisType, IteratorT>(self, ptr->left_ptr(), value, on_find))
+                    return false;
+            }
+            if (right_reaches && ptr->right_ptr() && !(ptr->right_ptr()->max() < value))
+                return stab_i<ThisType, IteratorT>(self, ptr->right_ptr(), value, on_find);
+            return true;
+        }
+
+        node_type* stab_first_i(node_type* ptr, value_type const& value) const
+        {
+            tree_hooks::template on_stab<this_type>(*this, ptr, value);
+            if (ptr->left_ptr() && !(ptr->left_ptr()->max() < value))
             {
-                return overlap_find_i<Exclusive>(ptr->right_, ival);
+                auto* res = stab_first_i(ptr->left_ptr(), value);
+                if (res != nullptr)
+                    return res;
             }
+            if (value < ptr->low())
+                return nullptr;
+            if (ptr->interval()->within(value))
+                return ptr;
+            if (ptr->right_ptr() && !(ptr->right_ptr()->max() < value))
+                return stab_first_i(ptr->right_ptr(), value);
             return nullptr;
         }
 
-        node_type* successor(node_type* node)
+        node_type* successor(node_type* node) const
         {
-            if (node->right_)
-                return minimum(node->right_);
-            auto* y = node->parent_;
-            while (y && node == y->right_)
+            if (node->right_ptr())
+                return minimum(node->right_ptr());
+            auto* y = node->parent_ptr();
+            while (y && node == y->right_ptr())
             {
                 node = y;
-                y = y->parent_;
+                y = y->parent_ptr();
             }
             return y;
         }
@@ -1912,78 +3816,204 @@ namespace lib_interval_tree
          */
         node_type* minimum(node_type* x) const
         {
-            while (x->left_)
-                x = x->left_;
+            while (x->left_ptr())
+                x = x->left_ptr();
             return x;
         }
 
         void left_rotate(node_type* x)
         {
-            auto* y = x->right_;
-            x->right_ = y->left_;
-            if (y->left_)
-                y->left_->parent_ = x;
+            auto* y = x->right_ptr();
+            x->set_right(y->left_ptr());
+            if (y->left_ptr())
+                y->left_ptr()->set_parent(x);
 
-            y->parent_ = x->parent_;
-            if (!x->parent_)
+            y->set_parent(x->parent_ptr());
+            if (!x->parent_ptr())
                 root_ = y;
             else if (x->is_left())
-                x->parent_->left_ = y;
+                x->parent_ptr()->set_left(y);
             else
-                x->parent_->right_ = y;
+                x->parent_ptr()->set_right(y);
 
-            y->left_ = x;
-            x->parent_ = y;
+            y->set_left(x);
+            x->set_parent(y);
 
             // max fixup
-            if (x->left_ && x->right_)
-                x->max_ = std::max(x->interval_.high(), std::max(x->left_->max_, x->right_->max_));
-            else if (x->left_)
-                x->max_ = std::max(x->interval_.high(), x->left_->max_);
-            else if (x->right_)
-                x->max_ = std::max(x->interval_.high(), x->right_->max_);
+            if (x->left_ptr() && x->right_ptr())
+                x->max_ = std::max(x->interval_.high(), std::max(x->left_ptr()->max_, x->right_ptr()->max_));
+            else if (x->left_ptr())
+                x->max_ = std::max(x->interval_.high(), x->left_ptr()->max_);
+            else if (x->right_ptr())
+                x->max_ = std::max(x->interval_.high(), x->right_ptr()->max_);
             else
                 x->max_ = x->interval_.high();
 
-            if (y->right_)
-                y->max_ = std::max(y->interval_.high(), std::max(y->right_->max_, x->max_));
+            if (y->right_ptr())
+                y->max_ = std::max(y->interval_.high(), std::max(y->right_ptr()->max_, x->max_));
             else
                 y->max_ = std::max(y->interval_.high(), x->max_);
+
+            refresh_aggregate(x, has_augmentation{});
+            refresh_aggregate(y, has_augmentation{});
         }
 
         void right_rotate(node_type* y)
         {
-            auto* x = y->left_;
-            y->left_ = x->right_;
+            auto* x = y->left_ptr();
+            y->set_left(x->right_ptr());
 
-            if (x->right_)
-                x->right_->parent_ = y;
+            if (x->right_ptr())
+                x->right_ptr()->set_parent(y);
 
-            x->parent_ = y->parent_;
-            if (!y->parent_)
+            x->set_parent(y->parent_ptr());
+            if (!y->parent_ptr())
                 root_ = x;
             else if (y->is_left())
-                y->parent_->left_ = x;
+                y->parent_ptr()->set_left(x);
             else
-                y->parent_->right_ = x;
+                y->parent_ptr()->set_right(x);
 
-            x->right_ = y;
-            y->parent_ = x;
+            x->set_right(y);
+            y->set_parent(x);
 
             // max fixup
-            if (y->left_ && y->right_)
-                y->max_ = std::max(y->interval_.high(), std::max(y->left_->max_, y->right_->max_));
-            else if (y->left_)
-                y->max_ = std::max(y->interval_.high(), y->left_->max_);
-            else if (y->right_)
-                y->max_ = std::max(y->interval_.high(), y->right_->max_);
+            if (y->left_ptr() && y->right_ptr())
+                y->max_ = std::max(y->interval_.high(), std::max(y->left_ptr()->max_, y->right_ptr()->max_));
+            else if (y->left_ptr())
+                y->max_ = std::max(y->interval_.high(), y->left_ptr()->max_);
+            else if (y->right_ptr())
+                y->max_ = std::max(y->interval_.high(), y->right_ptr()->max_);
             else
                 y->max_ = y->interval_.high();
 
-            if (x->left_)
-                x->max_ = std::max(x->interval_.high(), std::max(x->left_->max_, y->max_));
+            if (x->left_ptr())
+                x->max_ = std::max(x->interval_.high(), std::max(x->left_ptr()->max_, y->max_));
             else
                 x->max_ = std::max(x->interval_.high(), y->max_);
+
+            refresh_aggregate(y, has_augmentation{});
+            refresh_aggregate(x, has_augmentation{});
+        }
+
+        static aggregate_type aggregate_of(node_type const* node)
+        {
+            return node ? node->aggregate_ : augmentation_type::identity();
+        }
+
+        static aggregate_type aggregate_of_interval(node_type const* node)
+        {
+            return augmentation_type::from_interval(node->interval_);
+        }
+
+        static size_type subtree_size(node_type const* node)
+        {
+            return static_cast<size_type>(aggregate_of(node));
+        }
+
+        node_type* nth_node(size_type index) const
+        {
+            // A negative index runs off the left end.
+            for (auto* node = root_; node;)
+            {
+                const auto left = subtree_size(node->left_ptr());
+                if (index < left)
+                {
+                    node = node->left_ptr();
+                }
+                else if (left < index)
+                {
+                    index -= left + 1;
+                    node = node->right_ptr();
+                }
+                else
+                {
+                    return node;
+                }
+            }
+            return nullptr;
+        }
+
+        /**
+         *  Recomputes the aggregate of node from its interval and the aggregates of its children.
+         */
+        static void refresh_aggregate(node_type*, std::false_type) noexcept
+        {}
+        static void refresh_aggregate(node_type* node, std::true_type)
+        {
+            refresh_aggregate_impl(node, detail::aggregates_from_node<augmentation_type, node_type>{});
+        }
+        static void refresh_aggregate_impl(node_type* node, std::false_type)
+        {
+            node->aggregate_ = augmentation_type::combine(
+                augmentation_type::combine(aggregate_of(node->left_ptr()), aggregate_of_interval(node)),
+                aggregate_of(node->right_ptr())
+            );
+        }
+        static void refresh_aggregate_impl(node_type* node, std::true_type)
+        {
+            node->aggregate_ = augmentation_type::from_node(static_cast<node_type const&>(*node));
+        }
+
+        /**
+         *  Recomputes the aggregates from node up to the root, after a node below was linked or unlinked.
+         */
+        static void refresh_aggregates_upwards(node_type*, std::false_type) noexcept
+        {}
+        static void refresh_aggregates_upwards(node_type* node, std::true_type)
+        {
+            for (; node; node = node->parent_ptr())
+                refresh_aggregate(node, std::true_type{});
+        }
+
+        /**
+         *  The aggregate of the intervals in the subtree of node whose low is from or larger.
+         */
+        static aggregate_type fold_from(node_type const* node, value_type const& from)
+        {
+            auto result = augmentation_type::identity();
+            // Walking down, what is found later lies left of everything found so far.
+            while (node)
+            {
+                if (node->low() < from)
+                {
+                    node = node->right_ptr();
+                }
+                else
+                {
+                    result = augmentation_type::combine(
+                        augmentation_type::combine(aggregate_of_interval(node), aggregate_of(node->right_ptr())),
+                        result
+                    );
+                    node = node->left_ptr();
+                }
+            }
+            return result;
+        }
+
+        /**
+         *  The aggregate of the intervals in the subtree of node whose low is to or smaller.
+         */
+        static aggregate_type fold_to(node_type const* node, value_type const& to)
+        {
+            auto result = augmentation_type::identity();
+            // Walking down, what is found later lies right of everything found so far.
+            while (node)
+            {
+                if (to < node->low())
+                {
+                    node = node->left_ptr();
+                }
+                else
+                {
+                    result = augmentation_type::combine(
+                        result,
+                        augmentation_type::combine(aggregate_of(node->left_ptr()), aggregate_of_interval(node))
+                    );
+                    node = node->right_ptr();
+                }
+            }
+            return result;
         }
 
         void recalculate_max(node_type* reacalculation_root)
@@ -1993,11 +4023,11 @@ namespace lib_interval_tree
             auto* p = reacalculation_root;
             while (p && p->max_ <= reacalculation_root->max_)
             {
-                if (p->left_ && p->left_->max_ > p->max_)
-                    p->max_ = p->left_->max_;
-                if (p->right_ && p->right_->max_ > p->max_)
-                    p->max_ = p->right_->max_;
-                p = p->parent_;
+                if (p->left_ptr() && p->left_ptr()->max_ > p->max_)
+                    p->max_ = p->left_ptr()->max_;
+                if (p->right_ptr() && p->right_ptr()->max_ > p->max_)
+                    p->max_ = p->right_ptr()->max_;
+                p = p->parent_ptr();
             }
 
             tree_hooks::template on_after_recalculate_max<this_type>(*this, reacalculation_root);
@@ -2007,56 +4037,56 @@ namespace lib_interval_tree
         {
             tree_hooks::template on_before_insert_fixup<this_type>(*this, z);
 
-            while (z->parent_ && z->parent_->color_ == rb_color::red)
+            while (z->parent_ptr() && z->parent_ptr()->color() == rb_color::red)
             {
-                if (!z->parent_->parent_)
+                if (!z->parent_ptr()->parent_ptr())
                     break;
-                if (z->parent_ == z->parent_->parent_->left_)
+                if (z->parent_ptr() == z->parent_ptr()->parent_ptr()->left_ptr())
                 {
-                    node_type* y = z->parent_->parent_->right_;
-                    if (y && y->color_ == rb_color::red)
+                    node_type* y = z->parent_ptr()->parent_ptr()->right_ptr();
+                    if (y && y->color() == rb_color::red)
                     {
-                        z->parent_->color_ = rb_color::black;
-                        y->color_ = rb_color::black;
-                        z->parent_->parent_->color_ = rb_color::red;
-                        z = z->parent_->parent_;
+                        z->parent_ptr()->set_color(rb_color::black);
+                        y->set_color(rb_color::black);
+                        z->parent_ptr()->parent_ptr()->set_color(rb_color::red);
+                        z = z->parent_ptr()->parent_ptr();
                     }
                     else
                     {
-                        if (z == z->parent_->right_)
+                        if (z == z->parent_ptr()->right_ptr())
                         {
-                            z = z->parent_;
+                            z = z->parent_ptr();
                             left_rotate(z);
                         }
-                        z->parent_->color_ = rb_color::black;
-                        z->parent_->parent_->color_ = rb_color::red;
-                        right_rotate(z->parent_->parent_);
+                        z->parent_ptr()->set_color(rb_color::black);
+                        z->parent_ptr()->parent_ptr()->set_color(rb_color::red);
+                        right_rotate(z->parent_ptr()->parent_ptr());
                     }
                 }
                 else
                 {
-                    node_type* y = z->parent_->parent_->left_;
-                    if (y && y->color_ == rb_color::red)
+                    node_type* y = z->parent_ptr()->parent_ptr()->left_ptr();
+                    if (y && y->color() == rb_color::red)
                     {
-                        z->parent_->color_ = rb_color::black;
-                        y->color_ = rb_color::black;
-                        z->parent_->parent_->color_ = rb_color::red;
-                        z = z->parent_->parent_;
+                        z->parent_ptr()->set_color(rb_color::black);
+                        y->set_color(rb_color::black);
+                        z->parent_ptr()->parent_ptr()->set_color(rb_color::red);
+                        z = z->parent_ptr()->parent_ptr();
                     }
                     else
                     {
                         if (z->is_left())
                         {
-                            z = z->parent_;
+                            z = z->parent_ptr();
                             right_rotate(z);
                         }
-                        z->parent_->color_ = rb_color::black;
-                        z->parent_->parent_->color_ = rb_color::red;
-                        left_rotate(z->parent_->parent_);
+                        z->parent_ptr()->set_color(rb_color::black);
+                        z->parent_ptr()->parent_ptr()->set_color(rb_color::red);
+                        left_rotate(z->parent_ptr()->parent_ptr());
                     }
                 }
             }
-            root_->color_ = rb_color::black;
+            root_->set_color(rb_color::black);
 
             tree_hooks::template on_after_insert_fixup<this_type>(*this, z);
         }
@@ -2065,41 +4095,41 @@ namespace lib_interval_tree
         {
             tree_hooks::template on_before_erase_fixup<this_type>(*this, x, x_parent, y_is_left);
 
-            while (x != root_ && x->color_ == rb_color::black)
+            while (x != root_ && x->color() == rb_color::black)
             {
                 node_type* w;
                 if (y_is_left)
                 {
-                    w = x_parent->right_;
-                    if (w->color_ == rb_color::red)
+                    w = x_parent->right_ptr();
+                    if (w->color() == rb_color::red)
                     {
-                        w->color_ = rb_color::black;
-                        x_parent->color_ = rb_color::red;
+                        w->set_color(rb_color::black);
+                        x_parent->set_color(rb_color::red);
                         left_rotate(x_parent);
-                        w = x_parent->right_;
+                        w = x_parent->right_ptr();
                     }
 
-                    if (w->left_->color_ == rb_color::black && w->right_->color_ == rb_color::black)
+                    if (w->left_ptr()->color() == rb_color::black && w->right_ptr()->color() == rb_color::black)
                     {
-                        w->color_ = rb_color::red;
+                        w->set_color(rb_color::red);
                         x = x_parent;
-                        x_parent = x->parent_;
-                        y_is_left = (x == x_parent->left_);
+                        x_parent = x->parent_ptr();
+                        y_is_left = (x == x_parent->left_ptr());
                     }
                     else
                     {
-                        if (w->right_->color_ == rb_color::black)
+                        if (w->right_ptr()->color() == rb_color::black)
                         {
-                            w->left_->color_ = rb_color::black;
-                            w->color_ = rb_color::red;
+                            w->left_ptr()->set_color(rb_color::black);
+                            w->set_color(rb_color::red);
                             right_rotate(w);
-                            w = x_parent->right_;
+                            w = x_parent->right_ptr();
                         }
 
-                        w->color_ = x_parent->color_;
-                        x_parent->color_ = rb_color::black;
-                        if (w->right_)
-                            w->right_->color_ = rb_color::black;
+                        w->set_color(x_parent->color());
+                        x_parent->set_color(rb_color::black);
+                        if (w->right_ptr())
+                            w->right_ptr()->set_color(rb_color::black);
 
                         left_rotate(x_parent);
                         x = root_;
@@ -2108,36 +4138,36 @@ namespace lib_interval_tree
                 }
                 else
                 {
-                    w = x_parent->left_;
-                    if (w->color_ == rb_color::red)
+                    w = x_parent->left_ptr();
+                    if (w->color() == rb_color::red)
                     {
-                        w->color_ = rb_color::black;
-                        x_parent->color_ = rb_color::red;
+                        w->set_color(rb_color::black);
+                        x_parent->set_color(rb_color::red);
                         right_rotate(x_parent);
-                        w = x_parent->left_;
+                        w = x_parent->left_ptr();
                     }
 
-                    if (w->right_->color_ == rb_color::black && w->left_->color_ == rb_color::black)
+                    if (w->right_ptr()->color() == rb_color::black && w->left_ptr()->color() == rb_color::black)
                     {
-                        w->color_ = rb_color::red;
+                        w->set_color(rb_color::red);
                         x = x_parent;
-                        x_parent = x->parent_;
-                        y_is_left = (x == x_parent->left_);
+                        x_parent = x->parent_ptr();
+                        y_is_left = (x == x_parent->left_ptr());
                     }
                     else
                     {
-                        if (w->left_->color_ == rb_color::black)
+                        if (w->left_ptr()->color() == rb_color::black)
                         {
-                            w->right_->color_ = rb_color::black;
-                            w->color_ = rb_color::red;
+                            w->right_ptr()->set_color(rb_color::black);
+                            w->set_color(rb_color::red);
                             left_rotate(w);
-                            w = x_parent->left_;
+                            w = x_parent->left_ptr();
                         }
 
-                        w->color_ = x_parent->color_;
-                        x_parent->color_ = rb_color::black;
-                        if (w->left_)
-                            w->left_->color_ = rb_color::black;
+                        w->set_color(x_parent->color());
+                        x_parent->set_color(rb_color::black);
+                        if (w->left_ptr())
+                            w->left_ptr()->set_color(rb_color::black);
 
                         right_rotate(x_parent);
                         x = root_;
@@ -2146,7 +4176,7 @@ namespace lib_interval_tree
                 }
             }
 
-            x->color_ = rb_color::black;
+            x->set_color(rb_color::black);
 
             tree_hooks::template on_after_erase_fixup<this_type>(*this, x, x_parent, y_is_left);
         }
@@ -2154,9 +4184,55 @@ namespace lib_interval_tree
       private:
         node_type* root_;
         size_type size_;
+        node_storage_type storage_;
     };
     // ############################################################################################################
-    template <typename T, typename Kind = closed, typename tree_hooks = hooks::regular>
-    using interval_tree_t = interval_tree<interval<T, Kind>, tree_hooks>;
+    template <
+        typename T,
+        typename Kind = closed,
+        typename tree_hooks = hooks::regular,
+        typename Allocator = std::allocator<interval<T, Kind>>>
+    using interval_tree_t = interval_tree<interval<T, Kind>, tree_hooks, Allocator>;
+
+    /**
+     *  An interval_tree whose nodes are linked by 32 bit offsets and kept in one block, see index_links.
+     */
+    template <
+        typename T,
+        typename Kind = closed,
+        typename tree_hooks = hooks::regular,
+        typename Allocator = std::allocator<interval<T, Kind>>>
+    using index_linked_interval_tree_t = interval_tree<
+        interval<T, Kind>,
+        hooks::with_node_type<node<T, interval<T, Kind>, void, index_links>, tree_hooks>,
+        Allocator>;
+
+    /**
+     *  An interval_tree whose nodes keep subtree sizes, so it supports nth, rank, index_of_low and advance.
+     */
+    template <
+        typename T,
+        typename Kind = closed,
+        typename tree_hooks = hooks::regular,
+        typename Allocator = std::allocator<interval<T, Kind>>>
+    using ranked_interval_tree_t = interval_tree<
+        interval<T, Kind>,
+        hooks::with_augmentation<augmentations::count<std::size_t>, tree_hooks>,
+        Allocator>;
+    // ############################################################################################################
+    /**
+     *  Calls on_pair(a, b) for every interval a of tree_a that overlaps an interval b of tree_b.
+     *  See interval_tree::overlap_join.
+     */
+    template <typename IntervalT, typename tree_hooks, typename Allocator, typename FunctionT>
+    void overlap_join(
+        interval_tree<IntervalT, tree_hooks, Allocator> const& tree_a,
+        interval_tree<IntervalT, tree_hooks, Allocator> const& tree_b,
+        FunctionT const& on_pair,
+        bool exclusive = false
+    )
+    {
+        tree_a.overlap_join(tree_b, on_pair, exclusive);
+    }
     // ############################################################################################################
 }
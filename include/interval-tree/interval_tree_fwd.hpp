@@ -5,18 +5,32 @@ namespace lib_interval_tree
     template <typename numerical_type, typename interval_kind_>
     struct interval;
 
-    template <typename IntervalT, typename tree_hooks>
+    template <typename IntervalT, typename tree_hooks, typename Allocator>
     class interval_tree;
 
-    template <typename numerical_type, typename interval_type, typename derived>
+    template <typename IntervalT, typename Allocator>
+    class static_interval_index;
+
+    namespace detail
+    {
+        template <typename interval_type>
+        struct overlap_bounds;
+
+        struct parallel_access;
+    }
+
+    template <typename numerical_type, typename interval_type, typename derived, typename links>
     class node;
 
-    template <typename node_type, typename owner_type, typename tree_hooks>
+    template <typename numerical_type, typename interval_type, typename augmentation, typename derived, typename links>
+    class augmented_node;
+
+    template <typename node_type, typename owner_type, typename tree_hooks, typename allocator_type>
     class basic_interval_tree_iterator;
 
-    template <typename node_type, bool reverse, typename tree_hooks>
+    template <typename node_type, bool reverse, typename tree_hooks, typename allocator_type>
     class const_interval_tree_iterator;
 
-    template <typename node_type, bool reverse, typename tree_hooks>
+    template <typename node_type, bool reverse, typename tree_hooks, typename allocator_type>
     class interval_tree_iterator;
 }
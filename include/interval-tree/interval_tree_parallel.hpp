@@ -0,0 +1,343 @@
+#pragma once
+
+#include "interval_tree.hpp"
+#include "parallel_for.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <utility>
+#include <vector>
+
+/**
+ *  Algorithms that spread the work for a single interval_tree over several threads.
+ *  This header starts threads, link against the thread library of your platform (Threads::Threads in CMake).
+ */
+namespace lib_interval_tree
+{
+    namespace detail
+    {
+        /**
+         *  Amount of queries that a thread of parallel_overlap_find_batch takes at once.
+         */
+        constexpr std::size_t parallel_batch_grain = 64;
+
+        /**
+         *  parallel_overlap_find_all only uses threads if the query may visit more nodes than this.
+         */
+        constexpr std::size_t parallel_query_threshold = 1 << 16;
+
+        /**
+         *  A contiguous part of a random access container of queries.
+         */
+        template <typename QueriesT>
+        struct query_slice
+        {
+            QueriesT const& queries;
+            std::size_t offset;
+            std::size_t count;
+
+            std::size_t size() const noexcept
+            {
+                return count;
+            }
+
+            auto operator[](std::size_t index) const -> decltype(queries[offset + index])
+            {
+                return queries[offset + index];
+            }
+        };
+
+        /**
+         *  Sorts halves on separate threads and merges them, down to one range per thread.
+         */
+        template <typename RandomAccessIteratorT, typename CompareT>
+        void parallel_sort(
+            RandomAccessIteratorT first,
+            RandomAccessIteratorT last,
+            CompareT const& compare,
+            unsigned threads
+        )
+        {
+            constexpr std::ptrdiff_t min_parallel_size = 1 << 14;
+            if (threads <= 1 || last - first < min_parallel_size)
+            {
+                std::sort(first, last, compare);
+                return;
+            }
+
+            const auto middle = first + (last - first) / 2;
+            const unsigned left_threads = threads / 2;
+            std::thread left{[first, middle, &compare, left_threads]() {
+                parallel_sort(first, middle, compare, left_threads);
+            }};
+            parallel_sort(middle, last, compare, threads - left_threads);
+            left.join();
+            std::inplace_merge(first, middle, last, compare);
+        }
+        // ############################################################################################################
+        /**
+         *  The parts of the parallel algorithms that walk the nodes of a tree, interval_tree befriends this.
+         */
+        struct parallel_access
+        {
+            template <bool Exclusive, typename TreeT, typename ResultsT>
+            static void overlap_find_all(
+                TreeT const& tree,
+                typename TreeT::interval_type const& ival,
+                ResultsT& results,
+                unsigned threads
+            )
+            {
+                using node_type = typename TreeT::node_type;
+                using const_iterator = typename TreeT::const_iterator;
+                using bounds = overlap_bounds<typename TreeT::interval_type>;
+                const auto collect_into = [](ResultsT& target) {
+                    return [&target](const_iterator iter) {
+                        target.push_back(*iter);
+                        return true;
+                    };
+                };
+
+                // Subtrees whose roots pass the max test but are not searched yet, all at the same depth.
+                std::vector<node_type*> subtrees{tree.root_};
+                std::size_t depth = 0;
+                const std::size_t wanted_subtrees = static_cast<std::size_t>(threads) * 8;
+                while (threads > 1 && !subtrees.empty() && subtrees.size() < wanted_subtrees)
+                {
+                    std::vector<node_type*> next;
+                    for (auto* ptr : subtrees)
+                    {
+                        TreeT::tree_hooks_type::template on_overlap_find_all<TreeT>(tree, ptr, ival);
+                        const bool found =
+                            Exclusive ? ptr->interval()->overlaps_exclusive(ival) : ptr->interval()->overlaps(ival);
+                        if (found)
+                            results.push_back(*ptr->interval());
+                        if (ptr->left_ptr() && bounds::high_reaches(ptr->left_ptr()->max(), ival))
+                            next.push_back(ptr->left_ptr());
+                        if (ptr->right_ptr() && bounds::low_reaches(ptr->low(), ival) &&
+                            bounds::high_reaches(ptr->right_ptr()->max(), ival))
+                        {
+                            next.push_back(ptr->right_ptr());
+                        }
+                    }
+                    subtrees.swap(next);
+                    ++depth;
+                }
+
+                // The tree is balanced, so a subtree at depth d holds about size / 2^d nodes.
+                const auto estimated_nodes =
+                    subtrees.size() * (depth < 64 ? static_cast<std::size_t>(tree.size_) >> depth : std::size_t{0});
+                if (threads <= 1 || estimated_nodes < parallel_query_threshold)
+                {
+                    for (auto* ptr : subtrees)
+                    {
+                        TreeT::template overlap_find_all_i<TreeT, Exclusive, const_iterator>(
+                            &tree, ptr, ival, collect_into(results)
+                        );
+                    }
+                    return;
+                }
+
+                std::vector<ResultsT> buffers(subtrees.size());
+                parallel_for(subtrees.size(), threads, 1, [&](std::size_t first, std::size_t last) {
+                    for (auto i = first; i != last; ++i)
+                    {
+                        TreeT::template overlap_find_all_i<TreeT, Exclusive, const_iterator>(
+                            &tree, subtrees[i], ival, collect_into(buffers[i])
+                        );
+                    }
+                });
+                for (auto const& buffer : buffers)
+                    results.insert(results.end(), buffer.begin(), buffer.end());
+            }
+
+            template <bool Exclusive, typename TreeT, typename FunctionT>
+            static void overlap_join(TreeT const& tree, TreeT const& other, FunctionT const& on_pair, unsigned threads)
+            {
+                using const_iterator = typename TreeT::const_iterator;
+                using join_subtree = typename TreeT::join_subtree;
+                std::atomic<bool> stopped{false};
+                const auto guarded_on_pair = [&stopped, &on_pair](const_iterator a, const_iterator b) {
+                    if (stopped.load(std::memory_order_relaxed))
+                        return false;
+                    if (on_pair(a, b))
+                        return true;
+                    stopped = true;
+                    return false;
+                };
+
+                // Pairs of subtrees whose roots were not joined yet, expanded level by level.
+                using subtree_pair = std::pair<join_subtree, join_subtree>;
+                std::vector<subtree_pair> pairs{{{tree.root_, nullptr}, {other.root_, nullptr}}};
+                const std::size_t wanted_pairs = static_cast<std::size_t>(threads) * 8;
+                while (threads > 1 && !pairs.empty() && pairs.size() < wanted_pairs)
+                {
+                    std::vector<subtree_pair> next;
+                    for (auto const& pair : pairs)
+                    {
+                        const bool proceed = tree.template overlap_join_step<Exclusive>(
+                            other,
+                            pair.first,
+                            pair.second,
+                            guarded_on_pair,
+                            [&next](join_subtree lhs_child, join_subtree rhs_child) {
+                                next.emplace_back(lhs_child, rhs_child);
+                                return true;
+                            }
+                        );
+                        if (!proceed)
+                            return;
+                    }
+                    pairs.swap(next);
+                }
+
+                parallel_for(pairs.size(), threads, 1, [&](std::size_t first, std::size_t last) {
+                    for (auto i = first; i != last; ++i)
+                    {
+                        if (!tree.template overlap_join_i<Exclusive>(
+                                other, pairs[i].first, pairs[i].second, guarded_on_pair
+                            ))
+                        {
+                            return;
+                        }
+                    }
+                });
+            }
+        };
+    }
+    // ############################################################################################################
+    /**
+     *  Like interval_tree::assign_unsorted, but sorts on several threads.
+     *
+     *  @param threads The amount of threads to sort with, 0 for one per hardware thread. 1 sorts on the calling
+     *  thread.
+     */
+    template <typename IntervalT, typename tree_hooks, typename Allocator, typename InputIteratorT>
+    void parallel_assign_unsorted(
+        interval_tree<IntervalT, tree_hooks, Allocator>& tree,
+        InputIteratorT first,
+        InputIteratorT last,
+        unsigned threads = 0
+    )
+    {
+        std::vector<IntervalT> sorted(first, last);
+        detail::parallel_sort(
+            sorted.begin(),
+            sorted.end(),
+            [](IntervalT const& lhs, IntervalT const& rhs) {
+                return lhs.low() < rhs.low();
+            },
+            detail::resolve_thread_count(threads)
+        );
+        tree.assign(sorted.begin(), sorted.end());
+    }
+
+    /**
+     *  Runs overlap_find_all for all queries on several threads and stores the intervals that overlap queries[i]
+     *  into results[i]. The queries are handed out in chunks, idle threads steal chunks from busy ones.
+     *  Each thread runs its chunks through interval_tree::overlap_find_batch.
+     *
+     *  The tree must not be modified while this runs. The hooks for const searches, like on_overlap_find_all,
+     *  are called from several threads at once and have to be thread safe.
+     *
+     *  @param queries A random access container of interval_type, like std::vector.
+     *  @param results A container like std::vector<std::vector<interval_type>>. It is resized to the amount of
+     *  queries and every buffer is cleared first.
+     *  @param threads The amount of threads, 0 for one per hardware thread. The calling thread is one of them.
+     *  @param exclusive Exclude edges?
+     */
+    template <typename IntervalT, typename tree_hooks, typename Allocator, typename QueriesT, typename ResultsT>
+    void parallel_overlap_find_batch(
+        interval_tree<IntervalT, tree_hooks, Allocator> const& tree,
+        QueriesT const& queries,
+        ResultsT& results,
+        unsigned threads = 0,
+        bool exclusive = false
+    )
+    {
+        using const_iterator = typename interval_tree<IntervalT, tree_hooks, Allocator>::const_iterator;
+        results.resize(queries.size());
+        for (auto& result : results)
+            result.clear();
+        if (tree.empty())
+            return;
+
+        detail::parallel_for(
+            queries.size(),
+            threads,
+            detail::parallel_batch_grain,
+            [&tree, &queries, &results, exclusive](std::size_t first, std::size_t last) {
+                const detail::query_slice<QueriesT> slice{queries, first, last - first};
+                tree.overlap_find_batch(
+                    slice,
+                    [&results, first](std::size_t query, const_iterator iter) {
+                        results[first + query].push_back(*iter);
+                        return true;
+                    },
+                    exclusive
+                );
+            }
+        );
+    }
+
+    /**
+     *  Finds all intervals of tree that overlap with ival on several threads and appends them to results, which is
+     *  cleared first. The top levels of the tree are searched on the calling thread until there are enough subtrees
+     *  for all threads, the subtrees are then searched in parallel into separate buffers that are merged at the end.
+     *
+     *  Threads are only used when the subtrees that are left hold more than detail::parallel_query_threshold
+     *  nodes, narrow queries run on the calling thread only. Results are in unspecified order.
+     *  The tree must not be modified while this runs and hooks for const searches have to be thread safe.
+     *
+     *  @param ival The interval to find overlaps for.
+     *  @param results A container like std::vector<interval_type>.
+     *  @param threads The amount of threads, 0 for one per hardware thread. The calling thread is one of them.
+     *  @param exclusive Exclude edges?
+     */
+    template <typename IntervalT, typename tree_hooks, typename Allocator, typename ResultsT>
+    void parallel_overlap_find_all(
+        interval_tree<IntervalT, tree_hooks, Allocator> const& tree,
+        IntervalT const& ival,
+        ResultsT& results,
+        unsigned threads = 0,
+        bool exclusive = false
+    )
+    {
+        results.clear();
+        if (tree.empty())
+            return;
+        threads = detail::resolve_thread_count(threads);
+        if (exclusive)
+            detail::parallel_access::overlap_find_all<true>(tree, ival, results, threads);
+        else
+            detail::parallel_access::overlap_find_all<false>(tree, ival, results, threads);
+    }
+
+    /**
+     *  interval_tree::overlap_join on several threads. Pairs of subtrees from the top levels of both trees are joined
+     *  in parallel, on_pair is called from several threads at once and has to be thread safe.
+     *  Returning false from on_pair stops all threads, but pairs that are already found may still be reported.
+     *  The trees must not be modified while this runs.
+     *
+     *  @param threads The amount of threads, 0 for one per hardware thread. The calling thread is one of them.
+     */
+    template <typename IntervalT, typename tree_hooks, typename Allocator, typename FunctionT>
+    void parallel_overlap_join(
+        interval_tree<IntervalT, tree_hooks, Allocator> const& tree_a,
+        interval_tree<IntervalT, tree_hooks, Allocator> const& tree_b,
+        FunctionT const& on_pair,
+        unsigned threads = 0,
+        bool exclusive = false
+    )
+    {
+        if (tree_a.empty() || tree_b.empty())
+            return;
+        threads = detail::resolve_thread_count(threads);
+        if (exclusive)
+            detail::parallel_access::overlap_join<true>(tree_a, tree_b, on_pair, threads);
+        else
+            detail::parallel_access::overlap_join<false>(tree_a, tree_b, on_pair, threads);
+    }
+}
@@ -0,0 +1,156 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace lib_interval_tree
+{
+    namespace detail
+    {
+        // ############################################################################################################
+        /**
+         *  Returns threads, or the amount of hardware threads if threads is 0.
+         */
+        inline unsigned resolve_thread_count(unsigned threads) noexcept
+        {
+            if (threads != 0)
+                return threads;
+            return std::max(1u, std::thread::hardware_concurrency());
+        }
+        // ############################################################################################################
+        /**
+         *  The part of [0, count) that one worker of parallel_for still has to do.
+         *  The owner takes chunks from the front, thieves take the back half.
+         */
+        struct work_range
+        {
+            std::mutex mutex;
+            std::size_t begin = 0;
+            std::size_t end = 0;
+
+            bool take_front(std::size_t grain, std::size_t& first, std::size_t& last)
+            {
+                std::lock_guard<std::mutex> lock{mutex};
+                if (begin == end)
+                    return false;
+                first = begin;
+                last = std::min(end, begin + grain);
+                begin = last;
+                return true;
+            }
+
+            bool steal_back(std::size_t& first, std::size_t& last)
+            {
+                std::lock_guard<std::mutex> lock{mutex};
+                if (begin == end)
+                    return false;
+                first = begin + (end - begin) / 2;
+                last = end;
+                end = first;
+                return true;
+            }
+
+            void assign(std::size_t first, std::size_t last)
+            {
+                std::lock_guard<std::mutex> lock{mutex};
+                begin = first;
+                end = last;
+            }
+        };
+        // ############################################################################################################
+        /**
+         *  Calls function(first, last) for chunks of at most grain indices until [0, count) is covered.
+         *  Every worker starts with an equal share. A worker that runs dry steals half of what another worker has
+         *  left, so uneven chunks still keep all threads busy. The calling thread is one of the workers.
+         *
+         *  The first exception thrown by function stops all workers from taking new chunks and is rethrown.
+         *
+         *  @param threads The amount of workers, 0 for one per hardware thread.
+         */
+        template <typename FunctionT>
+        void parallel_for(std::size_t count, unsigned threads, std::size_t grain, FunctionT const& function)
+        {
+            grain = std::max<std::size_t>(grain, 1);
+            const std::size_t chunks = (count + grain - 1) / grain;
+            const auto workers = static_cast<std::size_t>(
+                std::min<std::size_t>(resolve_thread_count(threads), std::max<std::size_t>(chunks, 1))
+            );
+            if (workers <= 1)
+            {
+                for (std::size_t first = 0; first < count; first += grain)
+                    function(first, std::min(count, first + grain));
+                return;
+            }
+
+            std::vector<std::unique_ptr<work_range>> ranges;
+            ranges.reserve(workers);
+            for (std::size_t i = 0; i != workers; ++i)
+            {
+                ranges.push_back(std::make_unique<work_range>());
+                ranges.back()->begin = count * i / workers;
+                ranges.back()->end = count * (i + 1) / workers;
+            }
+
+            std::atomic<bool> failed{false};
+            std::exception_ptr error;
+            std::mutex error_mutex;
+
+            const auto work = [&](std::size_t self) {
+                std::size_t first = 0;
+                std::size_t last = 0;
+                try
+                {
+                    while (!failed.load(std::memory_order_relaxed))
+                    {
+                        if (!ranges[self]->take_front(grain, first, last))
+                        {
+                            bool stolen = false;
+                            for (std::size_t i = 1; i != workers && !stolen; ++i)
+                                stolen = ranges[(self + i) % workers]->steal_back(first, last);
+                            if (!stolen)
+                                return;
+                            ranges[self]->assign(first, last);
+                            continue;
+                        }
+                        function(first, last);
+                    }
+                }
+                catch (...)
+                {
+                    std::lock_guard<std::mutex> lock{error_mutex};
+                    if (!error)
+                        error = std::current_exception();
+                    failed = true;
+                }
+            };
+
+            std::vector<std::thread> pool;
+            pool.reserve(workers - 1);
+            try
+            {
+                for (std::size_t i = 1; i != workers; ++i)
+                    pool.emplace_back(work, i);
+            }
+            catch (...)
+            {
+                // Threads that did start finish the work of the ones that did not.
+                work(0);
+                for (auto& thread : pool)
+                    thread.join();
+                throw;
+            }
+            work(0);
+            for (auto& thread : pool)
+                thread.join();
+
+            if (error)
+                std::rethrow_exception(error);
+        }
+    }
+}
@@ -0,0 +1,595 @@
+#pragma once
+
+#include "interval_tree.hpp"
+#include "epoch_reclamation.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace lib_interval_tree
+{
+    namespace detail
+    {
+        /**
+         *  Node of a persistent_interval_tree. Nodes never change once a commit published them.
+         */
+        template <typename IntervalT>
+        struct persistent_node
+        {
+            using value_type = typename IntervalT::value_type;
+
+            persistent_node(IntervalT const& ival, std::uint64_t version)
+                : interval{ival}
+                , max{ival.high()}
+                , left{nullptr}
+                , right{nullptr}
+                , size{1}
+                , height{1}
+                , version{version}
+            {}
+
+            IntervalT interval;
+            value_type max;
+            persistent_node* left;
+            persistent_node* right;
+            std::size_t size;
+            int height;
+            /// The version that created this node. Nodes of the unpublished version can be changed in place.
+            std::uint64_t version;
+        };
+    }
+    // ############################################################################################################
+    /**
+     *  An interval tree with snapshot isolation for concurrent readers.
+     *
+     *  One writer changes the tree with insert and erase and publishes the changes with commit. Any thread can take
+     *  a snapshot of the last published version at any time, which stays unchanged and usable while the writer
+     *  goes on, so readers never wait for the writer and the writer never waits for readers.
+     *
+     *  Changes copy the path from the root to the changed node instead of rewriting nodes in place (path copying).
+     *  The tree is an AVL tree without parent pointers, so all versions share the untouched subtrees. Nodes that
+     *  were already copied since the last commit are changed in place, so a batch of changes only copies each
+     *  published node once. Replaced nodes are freed by epoch based reclamation once no snapshot can reach them.
+     *
+     *  All members except get_snapshot() must only be called by the writer. Snapshots must not outlive the tree.
+     */
+    template <typename IntervalT, typename Allocator = std::allocator<IntervalT>>
+    class persistent_interval_tree
+    {
+      public:
+        using interval_type = IntervalT;
+        using value_type = typename interval_type::value_type;
+        using allocator_type = Allocator;
+        using size_type = std::size_t;
+        using node_type = detail::persistent_node<interval_type>;
+
+      private:
+        using node_allocator_type = typename std::allocator_traits<allocator_type>::template rebind_alloc<node_type>;
+        using node_allocator_traits = std::allocator_traits<node_allocator_type>;
+        using bounds = detail::overlap_bounds<interval_type>;
+
+      public:
+        // ############################################################################################################
+        /**
+         *  A read only view of one published version. Queries on a snapshot are thread safe, a single snapshot
+         *  can be shared by several threads. Holding a snapshot keeps the nodes of its version alive.
+         */
+        class snapshot
+        {
+          public:
+            snapshot(snapshot const& other)
+                : domain_{other.domain_}
+                , record_{other.record_ ? other.domain_->pin_same(other.record_) : nullptr}
+                , root_{other.root_}
+            {}
+
+            snapshot(snapshot&& other) noexcept
+                : domain_{other.domain_}
+                , record_{other.record_}
+                , root_{other.root_}
+            {
+                other.record_ = nullptr;
+                other.root_ = nullptr;
+            }
+
+            snapshot& operator=(snapshot other) noexcept
+            {
+                std::swap(domain_, other.domain_);
+                std::swap(record_, other.record_);
+                std::swap(root_, other.root_);
+                return *this;
+            }
+
+            ~snapshot()
+            {
+                if (record_ != nullptr)
+                    detail::epoch_domain::unpin(record_);
+            }
+
+            size_type size() const noexcept
+            {
+                return root_ ? root_->size : 0;
+            }
+
+            bool empty() const noexcept
+            {
+                return root_ == nullptr;
+            }
+
+            /**
+             *  Calls on_find for every interval that overlaps ival, in ascending order of low.
+             *
+             *  @param on_find A function of type bool(interval_type const&). Return false to stop.
+             *  @param exclusive Exclude edges?
+             */
+            template <typename FunctionT>
+            void overlap_find_all(interval_type const& ival, FunctionT const& on_find, bool exclusive = false) const
+            {
+                if (exclusive)
+                    overlap_find_all_i<true>(root_, ival, on_find);
+                else
+                    overlap_find_all_i<false>(root_, ival, on_find);
+            }
+
+            /**
+             *  Calls on_find for every interval that contains value, as decided by interval_type::within,
+             *  in ascending order of low.
+             *
+             *  @param on_find A function of type bool(interval_type const&). Return false to stop.
+             */
+            template <typename FunctionT>
+            void stab(value_type const& value, FunctionT const& on_find) const
+            {
+                stab_i(root_, value, on_find);
+            }
+
+            /**
+             *  Calls function for every interval in ascending order of low.
+             *
+             *  @param function A function of type bool(interval_type const&). Return false to stop.
+             */
+            template <typename FunctionT>
+            void for_each(FunctionT const& function) const
+            {
+                for_each_i(root_, function);
+            }
+
+          private:
+            friend persistent_interval_tree;
+
+            snapshot(detail::epoch_domain* domain, detail::epoch_domain::reader_record* record, node_type* root)
+                : domain_{domain}
+                , record_{record}
+                , root_{root}
+            {}
+
+            template <bool Exclusive, typename FunctionT>
+            static bool overlap_find_all_i(node_type const* ptr, interval_type const& ival, FunctionT const& on_find)
+            {
+                if (ptr == nullptr || !bounds::high_reaches(ptr->max, ival))
+                    return true;
+                if (!overlap_find_all_i<Exclusive>(ptr->left, ival, on_find))
+                    return false;
+                if (!bounds::low_reaches(ptr->interval.low(), ival))
+                    return true;
+
+                bool overlaps = false;
+#if __cplusplus >= 201703L
+                if constexpr (Exclusive)
+#else
+                if (Exclusive)
+#endif
+                    overlaps = ptr->interval.overlaps_exclusive(ival);
+                else
+                    overlaps = ptr->interval.overlaps(ival);
+                if (overlaps && !on_find(ptr->interval))
+                    return false;
+                return overlap_find_all_i<Exclusive>(ptr->right, ival, on_find);
+            }
+
+            template <typename FunctionT>
+            static bool stab_i(node_type const* ptr, value_type const& value, FunctionT const& on_find)
+            {
+                if (ptr == nullptr || ptr->max < value)
+                    return true;
+                if (!stab_i(ptr->left, value, on_find))
+                    return false;
+                if (value < ptr->interval.low())
+                    return true;
+                if (ptr->interval.within(value) && !on_find(ptr->interval))
+                    return false;
+                return stab_i(ptr->right, value, on_find);
+            }
+
+            template <typename FunctionT>
+            static bool for_each_i(node_type const* ptr, FunctionT const& function)
+            {
+                if (ptr == nullptr)
+                    return true;
+                return for_each_i(ptr->left, function) && function(ptr->interval) &&
+                    for_each_i(ptr->right, function);
+            }
+
+          private:
+            detail::epoch_domain* domain_;
+            detail::epoch_domain::reader_record* record_;
+            node_type const* root_;
+        };
+
+      public:
+        explicit persistent_interval_tree(allocator_type const& allocator = allocator_type{})
+            : node_allocator_{allocator}
+            , root_{nullptr}
+            , published_{nullptr}
+            , version_{1}
+            , pending_{}
+            , retired_{}
+            , spare_{}
+            , domain_{}
+        {}
+
+        persistent_interval_tree(persistent_interval_tree const&) = delete;
+        persistent_interval_tree& operator=(persistent_interval_tree const&) = delete;
+
+        ~persistent_interval_tree()
+        {
+            for (auto* node : spare_)
+                node_allocator_traits::deallocate(node_allocator_, node, 1);
+            free_subtree(root_);
+            for (auto* node : pending_)
+                free_node(node);
+            for (auto& batch : retired_)
+            {
+                for (auto* node : batch.nodes)
+                    free_node(node);
+            }
+        }
+
+        /**
+         *  Adds ival to the writer's version. Readers see it after the next commit.
+         */
+        void insert(interval_type const& ival)
+        {
+            reserve_nodes();
+            root_ = insert_i(root_, ival);
+        }
+
+        /**
+         *  Removes one interval equal to ival from the writer's version.
+         *
+         *  @return Whether an interval was removed.
+         */
+        bool erase(interval_type const& ival)
+        {
+            bool erased = false;
+            reserve_nodes();
+            root_ = erase_i(root_, ival, erased);
+            return erased;
+        }
+
+        /**
+         *  Removes all intervals from the writer's version.
+         */
+        void clear()
+        {
+            pending_.reserve(pending_.size() + size());
+            retire_subtree(root_);
+            root_ = nullptr;
+        }
+
+        /**
+         *  Publishes the writer's version, so that following snapshots see it, and frees the nodes that no
+         *  snapshot can reach anymore.
+         */
+        void commit()
+        {
+            published_.store(root_);
+            ++version_;
+            const auto epoch = domain_.advance();
+            if (!pending_.empty())
+            {
+                retired_.push_back({epoch, std::move(pending_)});
+                pending_.clear();
+            }
+            reclaim();
+        }
+
+        /**
+         *  Frees retired nodes that no snapshot can reach anymore. commit calls this, but the writer may call it
+         *  on its own to free memory after long lived snapshots are gone.
+         */
+        void reclaim()
+        {
+            const auto oldest = domain_.oldest_pinned();
+            const auto reachable = std::find_if(retired_.begin(), retired_.end(), [oldest](retired_batch const& batch) {
+                return oldest < batch.epoch;
+            });
+            for (auto batch = retired_.begin(); batch != reachable; ++batch)
+            {
+                for (auto* node : batch->nodes)
+                    free_node(node);
+            }
+            retired_.erase(retired_.begin(), reachable);
+        }
+
+        /**
+         *  Returns a snapshot of the last published version. Can be called from any thread.
+         */
+        snapshot get_snapshot() const
+        {
+            auto* record = domain_.pin();
+            return snapshot{&domain_, record, published_.load()};
+        }
+
+        /**
+         *  The amount of intervals in the writer's version.
+         */
+        size_type size() const noexcept
+        {
+            return root_ ? root_->size : 0;
+        }
+
+        bool empty() const noexcept
+        {
+            return root_ == nullptr;
+        }
+
+        /**
+         *  The amount of replaced nodes that are not freed yet, because a snapshot or the writer may still reach them.
+         */
+        size_type retired_count() const noexcept
+        {
+            size_type count = pending_.size();
+            for (auto const& batch : retired_)
+                count += batch.nodes.size();
+            return count;
+        }
+
+        allocator_type get_allocator() const
+        {
+            return allocator_type{node_allocator_};
+        }
+
+      private:
+        struct retired_batch
+        {
+            std::uint64_t epoch;
+            std::vector<node_type*> nodes;
+        };
+
+        static int height(node_type const* ptr) noexcept
+        {
+            return ptr ? ptr->height : 0;
+        }
+
+        static void update(node_type* ptr) noexcept
+        {
+            ptr->max = ptr->interval.high();
+            ptr->size = 1;
+            ptr->height = 1;
+            for (auto const* child : {ptr->left, ptr->right})
+            {
+                if (child == nullptr)
+                    continue;
+                if (ptr->max < child->max)
+                    ptr->max = child->max;
+                ptr->size += child->size;
+                ptr->height = std::max(ptr->height, child->height + 1);
+            }
+        }
+
+        /**
+         *  Allocates the nodes that a single insert or erase may need up front, so that a change either fails
+         *  before it touches the tree or runs through. Copies happen along the path and, for rotations during erase,
+         *  at the two nodes next to it on every level.
+         */
+        void reserve_nodes()
+        {
+            const auto needed = static_cast<size_type>(3 * height(root_) + 4);
+            if (pending_.capacity() < pending_.size() + needed)
+                pending_.reserve(std::max(2 * pending_.capacity(), pending_.size() + needed));
+            spare_.reserve(needed);
+            while (spare_.size() < needed)
+                spare_.push_back(node_allocator_traits::allocate(node_allocator_, 1));
+        }
+
+        node_type* make_node(interval_type const& ival)
+        {
+            auto* ptr = spare_.back();
+            node_allocator_traits::construct(node_allocator_, ptr, ival, version_);
+            spare_.pop_back();
+            return ptr;
+        }
+
+        void free_node(node_type* ptr) noexcept
+        {
+            node_allocator_traits::destroy(node_allocator_, ptr);
+            node_allocator_traits::deallocate(node_allocator_, ptr, 1);
+        }
+
+        void free_subtree(node_type* ptr) noexcept
+        {
+            if (ptr == nullptr)
+                return;
+            free_subtree(ptr->left);
+            free_subtree(ptr->right);
+            free_node(ptr);
+        }
+
+        /**
+         *  Drops a node from the writer's version. Nodes that were never published are freed right away.
+         */
+        void release(node_type* ptr)
+        {
+            if (ptr->version == version_)
+                free_node(ptr);
+            else
+                pending_.push_back(ptr);
+        }
+
+        void retire_subtree(node_type* ptr)
+        {
+            if (ptr == nullptr)
+                return;
+            retire_subtree(ptr->left);
+            retire_subtree(ptr->right);
+            release(ptr);
+        }
+
+        /**
+         *  Returns a node of the writer's version with the contents of ptr, copying ptr if it was published.
+         */
+        node_type* writable(node_type* ptr)
+        {
+            if (ptr->version == version_)
+                return ptr;
+            auto* copy = make_node(ptr->interval);
+            copy->max = ptr->max;
+            copy->left = ptr->left;
+            copy->right = ptr->right;
+            copy->size = ptr->size;
+            copy->height = ptr->height;
+            pending_.push_back(ptr);
+            return copy;
+        }
+
+        node_type* rotate_right(node_type* ptr)
+        {
+            auto* left = writable(ptr->left);
+            ptr->left = left->right;
+            update(ptr);
+            left->right = ptr;
+            update(left);
+            return left;
+        }
+
+        node_type* rotate_left(node_type* ptr)
+        {
+            auto* right = writable(ptr->right);
+            ptr->right = right->left;
+            update(ptr);
+            right->left = ptr;
+            update(right);
+            return right;
+        }
+
+        /**
+         *  Restores the AVL balance of a writable node whose subtrees differ in height by at most 2.
+         */
+        node_type* rebalance(node_type* ptr)
+        {
+            update(ptr);
+            const int balance = height(ptr->left) - height(ptr->right);
+            if (balance > 1)
+            {
+                if (height(ptr->left->left) < height(ptr->left->right))
+                    ptr->left = rotate_left(writable(ptr->left));
+                return rotate_right(ptr);
+            }
+            if (balance < -1)
+            {
+                if (height(ptr->right->right) < height(ptr->right->left))
+                    ptr->right = rotate_right(writable(ptr->right));
+                return rotate_left(ptr);
+            }
+            return ptr;
+        }
+
+        node_type* insert_i(node_type* ptr, interval_type const& ival)
+        {
+            if (ptr == nullptr)
+                return make_node(ival);
+            ptr = writable(ptr);
+            if (ival.low() < ptr->interval.low())
+                ptr->left = insert_i(ptr->left, ival);
+            else
+                ptr->right = insert_i(ptr->right, ival);
+            return rebalance(ptr);
+        }
+
+        node_type* erase_i(node_type* ptr, interval_type const& ival, bool& erased)
+        {
+            if (ptr == nullptr)
+                return nullptr;
+
+            // Rotations can move intervals with the same low to either side, so both are searched then.
+            const bool go_left = !(ptr->interval.low() < ival.low());
+            const bool go_right = !(ival.low() < ptr->interval.low());
+            if (go_left && go_right && ptr->interval == ival)
+            {
+                erased = true;
+                return remove_node(ptr);
+            }
+            if (go_left)
+            {
+                auto* left = erase_i(ptr->left, ival, erased);
+                if (erased)
+                {
+                    ptr = writable(ptr);
+                    ptr->left = left;
+                    return rebalance(ptr);
+                }
+            }
+            if (go_right)
+            {
+                auto* right = erase_i(ptr->right, ival, erased);
+                if (erased)
+                {
+                    ptr = writable(ptr);
+                    ptr->right = right;
+                    return rebalance(ptr);
+                }
+            }
+            return ptr;
+        }
+
+        node_type* remove_node(node_type* ptr)
+        {
+            if (ptr->left == nullptr || ptr->right == nullptr)
+            {
+                auto* child = ptr->left ? ptr->left : ptr->right;
+                release(ptr);
+                return child;
+            }
+
+            node_type* minimum = nullptr;
+            auto* right = remove_minimum(ptr->right, minimum);
+            ptr = writable(ptr);
+            ptr->interval = minimum->interval;
+            ptr->right = right;
+            release(minimum);
+            return rebalance(ptr);
+        }
+
+        /**
+         *  Unlinks the leftmost node of the subtree into minimum, without releasing it.
+         */
+        node_type* remove_minimum(node_type* ptr, node_type*& minimum)
+        {
+            if (ptr->left == nullptr)
+            {
+                minimum = ptr;
+                return ptr->right;
+            }
+            auto* left = remove_minimum(ptr->left, minimum);
+            ptr = writable(ptr);
+            ptr->left = left;
+            return rebalance(ptr);
+        }
+
+      private:
+        node_allocator_type node_allocator_;
+        node_type* root_;
+        std::atomic<node_type*> published_;
+        std::uint64_t version_;
+        std::vector<node_type*> pending_;
+        std::vector<retired_batch> retired_;
+        std::vector<node_type*> spare_;
+        mutable detail::epoch_domain domain_;
+    };
+}
@@ -0,0 +1,419 @@
+#pragma once
+
+#include "interval_tree.hpp"
+#include "shared_mutex.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+namespace lib_interval_tree
+{
+    // ############################################################################################################
+    struct sharded_options
+    {
+        /**
+         *  A rebalance is started when a shard holds more than max_skew times the average amount of intervals.
+         */
+        double max_skew = 2.0;
+
+        /**
+         *  Shards are not rebalanced automatically while the tree holds fewer intervals than this.
+         */
+        std::size_t min_rebalance_size = 4096;
+    };
+    // ############################################################################################################
+    /**
+     *  An interval index for many concurrent writers, split into shards by ranges of the value domain.
+     *
+     *  Every shard is an interval_tree with its own lock. An interval is stored in every shard its [low, high]
+     *  touches, so inserts and erases on different shards run in parallel. Queries visit the shards that they
+     *  touch and report every interval from the first shard that holds it and is visited, so each interval is
+     *  reported once without keeping track of what was reported.
+     *
+     *  Shard boundaries are moved to the quantiles of the lows when a shard becomes much bigger than the average,
+     *  see sharded_options. Rebalancing locks out all other operations while it rebuilds the shards.
+     *
+     *  All members are thread safe. Callbacks are called while the shard they come from is locked for reading,
+     *  they must not change the tree.
+     */
+    template <typename IntervalT, typename Allocator = std::allocator<IntervalT>>
+    class sharded_interval_tree
+    {
+      public:
+        using interval_type = IntervalT;
+        using value_type = typename interval_type::value_type;
+        using size_type = std::size_t;
+        using tree_type = interval_tree<interval_type, hooks::regular, Allocator>;
+
+      public:
+        /**
+         *  Splits [domain_low, domain_high] into shard_count ranges of equal width. Values outside of the domain
+         *  belong to the first or last shard.
+         */
+        sharded_interval_tree(
+            std::size_t shard_count,
+            value_type const& domain_low,
+            value_type const& domain_high,
+            sharded_options const& options = {}
+        )
+            : options_{options}
+            , boundaries_{}
+            , shards_{}
+            , size_{0}
+            , rebalance_floor_{options.min_rebalance_size}
+        {
+            if (shard_count == 0)
+                throw std::invalid_argument("sharded_interval_tree needs at least one shard");
+            if (domain_high < domain_low)
+                throw std::invalid_argument("Low border is not lower or equal to high border.");
+
+            for (std::size_t i = 1; i < shard_count; ++i)
+            {
+                const auto width = static_cast<long double>(domain_high) - static_cast<long double>(domain_low);
+                boundaries_.push_back(
+                    static_cast<value_type>(domain_low + width * static_cast<long double>(i) / shard_count)
+                );
+            }
+            for (std::size_t i = 0; i != shard_count; ++i)
+                shards_.push_back(std::make_unique<shard>());
+        }
+
+        sharded_interval_tree(sharded_interval_tree const&) = delete;
+        sharded_interval_tree& operator=(sharded_interval_tree const&) = delete;
+
+        void insert(interval_type const& ival)
+        {
+            bool skewed = false;
+            {
+                std::shared_lock<detail::shared_mutex> layout{layout_mutex_};
+                const auto first = shard_of(ival.low());
+                const auto last = shard_of(ival.high());
+                const shard_range_lock lock{shards_, first, last};
+                for (auto i = first; i <= last; ++i)
+                {
+                    try
+                    {
+                        shards_[i]->tree.insert(ival);
+                    }
+                    catch (...)
+                    {
+                        for (auto j = first; j != i; ++j)
+                            shards_[j]->tree.erase(shards_[j]->tree.find(ival));
+                        throw;
+                    }
+                }
+                for (auto i = first; i <= last; ++i)
+                    ++shards_[i]->stored;
+                ++size_;
+                skewed = is_skewed();
+            }
+            if (skewed)
+                rebalance_if_skewed();
+        }
+
+        /**
+         *  Erases one interval that is equal to ival.
+         *
+         *  @return Whether an interval was erased.
+         */
+        bool erase(interval_type const& ival)
+        {
+            std::shared_lock<detail::shared_mutex> layout{layout_mutex_};
+            const auto first = shard_of(ival.low());
+            const auto last = shard_of(ival.high());
+            const shard_range_lock lock{shards_, first, last};
+            if (shards_[first]->tree.find(ival) == shards_[first]->tree.end())
+                return false;
+
+            for (auto i = first; i <= last; ++i)
+            {
+                auto& tree = shards_[i]->tree;
+                tree.erase(tree.find(ival));
+                --shards_[i]->stored;
+            }
+            --size_;
+            return true;
+        }
+
+        /**
+         *  Calls on_find once for every interval that overlaps ival. The shards are visited one after another in
+         *  ascending order, intervals of one shard are reported in ascending order of low.
+         *
+         *  @param on_find A function of type bool(interval_type const&). Return false to stop.
+         *  @param exclusive Exclude edges?
+         */
+        template <typename FunctionT>
+        void overlap_find_all(interval_type const& ival, FunctionT const& on_find, bool exclusive = false) const
+        {
+            std::shared_lock<detail::shared_mutex> layout{layout_mutex_};
+            const auto first = shard_of(widened_low(ival.low()));
+            const auto last = shard_of(widened_high(ival.high()));
+            for (auto i = first; i <= last; ++i)
+            {
+                std::shared_lock<detail::shared_mutex> lock{shards_[i]->mutex};
+                tree_type const& tree = shards_[i]->tree;
+                bool proceed = true;
+                tree.overlap_find_all(
+                    ival,
+                    [this, i, first, &on_find, &proceed](typename tree_type::const_iterator iter) {
+                        // Reported by the first shard that holds the interval and is visited.
+                        if (std::max(shard_of(iter->low()), first) != i)
+                            return true;
+                        proceed = on_find(*iter);
+                        return proceed;
+                    },
+                    exclusive
+                );
+                if (!proceed)
+                    return;
+            }
+        }
+
+        /**
+         *  Calls on_find for every interval that contains value, as decided by interval_type::within.
+         *  Only the shard of value is visited.
+         *
+         *  @param on_find A function of type bool(interval_type const&). Return false to stop.
+         */
+        template <typename FunctionT>
+        void stab(value_type const& value, FunctionT const& on_find) const
+        {
+            std::shared_lock<detail::shared_mutex> layout{layout_mutex_};
+            auto const& target = *shards_[shard_of(value)];
+            std::shared_lock<detail::shared_mutex> lock{target.mutex};
+            tree_type const& tree = target.tree;
+            tree.stab(value, [&on_find](typename tree_type::const_iterator iter) {
+                return on_find(*iter);
+            });
+        }
+
+        /**
+         *  Moves the shard boundaries to the quantiles of the lows of all intervals and rebuilds the shards.
+         *  Blocks all other operations while it runs.
+         */
+        void rebalance()
+        {
+            std::unique_lock<detail::shared_mutex> layout{layout_mutex_};
+            rebalance_i();
+        }
+
+        /**
+         *  The amount of intervals, intervals that are stored in several shards count once.
+         */
+        size_type size() const noexcept
+        {
+            return size_.load();
+        }
+
+        bool empty() const noexcept
+        {
+            return size() == 0;
+        }
+
+        std::size_t shard_count() const noexcept
+        {
+            return shards_.size();
+        }
+
+        /**
+         *  The amount of intervals stored in every shard, including intervals that reach into it from others.
+         */
+        std::vector<size_type> shard_sizes() const
+        {
+            std::shared_lock<detail::shared_mutex> layout{layout_mutex_};
+            std::vector<size_type> sizes;
+            for (auto const& shard : shards_)
+                sizes.push_back(shard->stored.load());
+            return sizes;
+        }
+
+        /**
+         *  The lowest value of every shard but the first.
+         */
+        std::vector<value_type> boundaries() const
+        {
+            std::shared_lock<detail::shared_mutex> layout{layout_mutex_};
+            return boundaries_;
+        }
+
+      private:
+        struct shard
+        {
+            mutable detail::shared_mutex mutex;
+            tree_type tree;
+            std::atomic<size_type> stored{0};
+        };
+
+        /**
+         *  Adjacent intervals overlap without sharing a value, the query has to reach one further to meet them.
+         */
+        static constexpr bool adjacent_overlaps =
+            std::is_base_of<detail::adjacent_overlap_bounds, detail::overlap_bounds<interval_type>>::value;
+
+        static value_type widened_low(value_type const& low)
+        {
+#if __cplusplus >= 201703L
+            if constexpr (adjacent_overlaps)
+#else
+            if (adjacent_overlaps)
+#endif
+            {
+                if (low != std::numeric_limits<value_type>::lowest())
+                    return low - 1;
+            }
+            return low;
+        }
+
+        static value_type widened_high(value_type const& high)
+        {
+#if __cplusplus >= 201703L
+            if constexpr (adjacent_overlaps)
+#else
+            if (adjacent_overlaps)
+#endif
+            {
+                if (high != std::numeric_limits<value_type>::max())
+                    return high + 1;
+            }
+            return high;
+        }
+
+        std::size_t shard_of(value_type const& value) const
+        {
+            return static_cast<std::size_t>(
+                std::upper_bound(boundaries_.begin(), boundaries_.end(), value) - boundaries_.begin()
+            );
+        }
+
+        /**
+         *  Locks the shards [first, last] for writing, in ascending order so that writers cannot deadlock.
+         */
+        class shard_range_lock
+        {
+          public:
+            shard_range_lock(std::vector<std::unique_ptr<shard>> const& shards, std::size_t first, std::size_t last)
+                : shards_{shards}
+                , first_{first}
+                , locked_{first}
+            {
+                try
+                {
+                    for (; locked_ <= last; ++locked_)
+                        shards_[locked_]->mutex.lock();
+                }
+                catch (...)
+                {
+                    unlock();
+                    throw;
+                }
+            }
+
+            ~shard_range_lock()
+            {
+                unlock();
+            }
+
+            shard_range_lock(shard_range_lock const&) = delete;
+            shard_range_lock& operator=(shard_range_lock const&) = delete;
+
+          private:
+            void unlock() noexcept
+            {
+                for (auto i = first_; i != locked_; ++i)
+                    shards_[i]->mutex.unlock();
+            }
+
+          private:
+            std::vector<std::unique_ptr<shard>> const& shards_;
+            std::size_t first_;
+            std::size_t locked_;
+        };
+
+        /**
+         *  Needs at least a shared lock on the layout.
+         */
+        bool is_skewed() const
+        {
+            const auto size = size_.load();
+            if (size < rebalance_floor_.load())
+                return false;
+            const auto limit = options_.max_skew * static_cast<double>(size) / static_cast<double>(shards_.size());
+            return std::any_of(shards_.begin(), shards_.end(), [limit](std::unique_ptr<shard> const& shard) {
+                return static_cast<double>(shard->stored.load()) > limit;
+            });
+        }
+
+        void rebalance_if_skewed()
+        {
+            std::unique_lock<detail::shared_mutex> layout{layout_mutex_};
+            // Another thread may have rebalanced in the meantime.
+            if (is_skewed())
+                rebalance_i();
+        }
+
+        void rebalance_i()
+        {
+            // Every interval once, from the shard of its low, which holds the intervals in ascending order of low.
+            std::vector<interval_type> intervals;
+            intervals.reserve(size_.load());
+            for (std::size_t i = 0; i != shards_.size(); ++i)
+            {
+                for (auto const& ival : shards_[i]->tree)
+                {
+                    if (shard_of(ival.low()) == i)
+                        intervals.push_back(ival);
+                }
+            }
+
+            std::vector<value_type> boundaries;
+            for (std::size_t i = 1; i < shards_.size(); ++i)
+            {
+                if (intervals.empty())
+                    boundaries.push_back(boundaries_[i - 1]);
+                else
+                    boundaries.push_back(intervals[intervals.size() * i / shards_.size()].low());
+            }
+
+            std::vector<std::vector<interval_type>> contents(shards_.size());
+            const auto new_shard_of = [&boundaries](value_type const& value) {
+                return static_cast<std::size_t>(
+                    std::upper_bound(boundaries.begin(), boundaries.end(), value) - boundaries.begin()
+                );
+            };
+            for (auto const& ival : intervals)
+            {
+                const auto last = new_shard_of(ival.high());
+                for (auto i = new_shard_of(ival.low()); i <= last; ++i)
+                    contents[i].push_back(ival);
+            }
+
+            std::vector<std::unique_ptr<shard>> shards;
+            for (auto const& content : contents)
+            {
+                shards.push_back(std::make_unique<shard>());
+                shards.back()->tree.assign(content.begin(), content.end());
+                shards.back()->stored = content.size();
+            }
+
+            boundaries_.swap(boundaries);
+            shards_.swap(shards);
+            rebalance_floor_ = std::max(options_.min_rebalance_size, intervals.size() + intervals.size() / 2);
+        }
+
+      private:
+        sharded_options options_;
+        mutable detail::shared_mutex layout_mutex_;
+        std::vector<value_type> boundaries_;
+        std::vector<std::unique_ptr<shard>> shards_;
+        std::atomic<size_type> size_;
+        std::atomic<size_type> rebalance_floor_;
+    };
+}
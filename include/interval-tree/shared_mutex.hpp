@@ -0,0 +1,18 @@
+#pragma once
+
+#include <shared_mutex>
+
+namespace lib_interval_tree
+{
+    namespace detail
+    {
+        /**
+         *  A reader writer lock, std::shared_mutex is C++17.
+         */
+#if __cplusplus >= 201703L
+        using shared_mutex = std::shared_mutex;
+#else
+        using shared_mutex = std::shared_timed_mutex;
+#endif
+    }
+}
@@ -0,0 +1,340 @@
+#pragma once
+
+#include "interval_tree_fwd.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace lib_interval_tree
+{
+    // ############################################################################################################
+    /**
+     *  An immutable interval index for trees that are built once and queried a lot.
+     *
+     *  The intervals are kept in one array sorted by low. The array doubles as an implicit balanced tree
+     *  (the layout of cgranges): the node at index i is on level k = number of trailing one bits of i,
+     *  its children are i -/+ 2^(k-1) and a parallel array holds the max of high over every subtree.
+     *  Queries walk that implicit tree on contiguous memory instead of chasing node pointers and report the
+     *  intervals in ascending order of low.
+     *
+     *  Callbacks receive a const_iterator into the sorted array and return false to stop searching,
+     *  like the callbacks of interval_tree.
+     */
+    template <typename IntervalT, typename Allocator = std::allocator<IntervalT>>
+    class static_interval_index
+    {
+      public:
+        using interval_type = IntervalT;
+        using value_type = typename interval_type::value_type;
+        using allocator_type = Allocator;
+        using size_type = std::size_t;
+
+        using interval_storage = std::vector<interval_type, allocator_type>;
+        using max_storage =
+            std::vector<value_type, typename std::allocator_traits<allocator_type>::template rebind_alloc<value_type>>;
+
+        using const_iterator = typename interval_storage::const_iterator;
+        using iterator = const_iterator;
+
+      public:
+        explicit static_interval_index(allocator_type const& allocator = allocator_type{})
+            : intervals_(allocator)
+            , max_(allocator)
+            , max_level_{0}
+        {}
+
+        /**
+         *  Builds the index from any range of intervals. Sorting is skipped if the range is sorted by low already.
+         */
+        template <typename InputIteratorT>
+        static_interval_index(
+            InputIteratorT first,
+            InputIteratorT last,
+            allocator_type const& allocator = allocator_type{}
+        )
+            : intervals_(first, last, allocator)
+            , max_(allocator)
+            , max_level_{0}
+        {
+            const auto by_low = [](interval_type const& lhs, interval_type const& rhs) {
+                return lhs.low() < rhs.low();
+            };
+            if (!std::is_sorted(intervals_.begin(), intervals_.end(), by_low))
+                std::stable_sort(intervals_.begin(), intervals_.end(), by_low);
+            build();
+        }
+
+        /**
+         *  Builds the index from an interval_tree, which is iterated in order of low already.
+         */
+        template <typename tree_hooks>
+        explicit static_interval_index(interval_tree<interval_type, tree_hooks, allocator_type> const& tree)
+            : intervals_(tree.get_allocator())
+            , max_(tree.get_allocator())
+            , max_level_{0}
+        {
+            intervals_.reserve(static_cast<size_type>(tree.size()));
+            for (auto const& ival : tree)
+                intervals_.push_back(ival);
+            build();
+        }
+
+        size_type size() const noexcept
+        {
+            return intervals_.size();
+        }
+
+        bool empty() const noexcept
+        {
+            return intervals_.empty();
+        }
+
+        /**
+         *  Intervals in ascending order of low.
+         */
+        const_iterator begin() const noexcept
+        {
+            return intervals_.begin();
+        }
+
+        const_iterator end() const noexcept
+        {
+            return intervals_.end();
+        }
+
+        const_iterator cbegin() const noexcept
+        {
+            return intervals_.cbegin();
+        }
+
+        const_iterator cend() const noexcept
+        {
+            return intervals_.cend();
+        }
+
+        allocator_type get_allocator() const
+        {
+            return intervals_.get_allocator();
+        }
+
+        /**
+         *  Finds all intervals that overlap with ival, in ascending order of low.
+         *
+         *  @param ival The interval to find overlaps for.
+         *  @param on_find Called with a const_iterator for every overlap, return false to stop.
+         *  @param exclusive Exclude edges?
+         */
+        template <typename FunctionT>
+        void overlap_find_all(interval_type const& ival, FunctionT const& on_find, bool exclusive = false) const
+        {
+            if (exclusive)
+                overlap_search<true>(ival, on_find);
+            else
+                overlap_search<false>(ival, on_find);
+        }
+
+        /**
+         *  Finds the overlapping interval with the lowest low, or end() if there is none.
+         */
+        const_iterator overlap_find(interval_type const& ival, bool exclusive = false) const
+        {
+            auto result = end();
+            overlap_find_all(
+                ival,
+                [&result](const_iterator iter) {
+                    result = iter;
+                    return false;
+                },
+                exclusive
+            );
+            return result;
+        }
+
+        /**
+         *  Finds all exact matches, in ascending order of low.
+         */
+        template <typename FunctionT>
+        void find_all(interval_type const& ival, FunctionT const& on_find) const
+        {
+            auto iter = std::lower_bound(
+                intervals_.begin(),
+                intervals_.end(),
+                ival.low(),
+                [](interval_type const& lhs, value_type const& low) {
+                    return lhs.low() < low;
+                }
+            );
+            for (; iter != intervals_.end() && !(ival.low() < iter->low()); ++iter)
+            {
+                if (*iter == ival && !on_find(iter))
+                    return;
+            }
+        }
+
+        /**
+         *  Finds all intervals for which compare(interval, ival) holds. Like for interval_tree, subtrees are
+         *  skipped if their max is below ival.high().
+         */
+        template <typename FunctionT, typename CompareFunctionT>
+        void find_all(interval_type const& ival, FunctionT const& on_find, CompareFunctionT const& compare) const
+        {
+            search(
+                [&ival](value_type const& max) {
+                    return !(max < ival.high());
+                },
+                [](interval_type const&) {
+                    return false;
+                },
+                [&](size_type index) {
+                    if (compare(intervals_[index], ival))
+                        return on_find(begin() + static_cast<std::ptrdiff_t>(index));
+                    return true;
+                }
+            );
+        }
+
+        /**
+         *  Finds the first exact match, or end() if there is none.
+         */
+        const_iterator find(interval_type const& ival) const
+        {
+            auto result = end();
+            find_all(ival, [&result](const_iterator iter) {
+                result = iter;
+                return false;
+            });
+            return result;
+        }
+
+      private:
+        template <bool Exclusive, typename FunctionT>
+        void overlap_search(interval_type const& ival, FunctionT const& on_find) const
+        {
+            using bounds = detail::overlap_bounds<interval_type>;
+            search(
+                [&ival](value_type const& max) {
+                    return bounds::high_reaches(max, ival);
+                },
+                [&ival](interval_type const& candidate) {
+                    // Sorted by low, nothing from here on can overlap.
+                    return !bounds::low_reaches(candidate.low(), ival);
+                },
+                [&](size_type index) {
+                    if (overlaps<Exclusive>(intervals_[index], ival))
+                        return on_find(begin() + static_cast<std::ptrdiff_t>(index));
+                    return true;
+                }
+            );
+        }
+
+        template <bool Exclusive>
+        static bool overlaps(interval_type const& lhs, interval_type const& rhs)
+        {
+            return Exclusive ? lhs.overlaps_exclusive(rhs) : lhs.overlaps(rhs);
+        }
+
+        /**
+         *  Computes the subtree maxima bottom up, level by level.
+         */
+        void build()
+        {
+            const auto n = intervals_.size();
+            max_.resize(n);
+            max_level_ = 0;
+            if (n == 0)
+                return;
+
+            // Leaves are on even indices. last_i is the rightmost node of the current level, subtrees that hang
+            // off the end of the array get its max.
+            size_type last_i = 0;
+            value_type last = intervals_[0].high();
+            for (size_type i = 0; i < n; i += 2)
+            {
+                last_i = i;
+                last = max_[i] = intervals_[i].high();
+            }
+
+            int k = 1;
+            for (; (size_type{1} << k) <= n; ++k)
+            {
+                const size_type x = size_type{1} << (k - 1);
+                const size_type step = x << 2;
+                for (size_type i = (x << 1) - 1; i < n; i += step)
+                {
+                    const value_type& left = max_[i - x];
+                    const value_type& right = i + x < n ? max_[i + x] : last;
+                    max_[i] = std::max(intervals_[i].high(), std::max(left, right));
+                }
+                last_i = ((last_i >> k) & 1) ? last_i - x : last_i + x;
+                if (last_i < n && last < max_[last_i])
+                    last = max_[last_i];
+            }
+            max_level_ = k - 1;
+        }
+
+        /**
+         *  Walks the implicit tree in order.
+         *
+         *  @param descend Is called with the max of a left subtree, whether it may contain a match.
+         *  @param past_end Whether no interval from this one on (in order of low) can match.
+         *  @param on_candidate Called for every remaining interval, return false to stop.
+         */
+        template <typename DescendT, typename PastEndT, typename CandidateT>
+        void search(DescendT const& descend, PastEndT const& past_end, CandidateT const& on_candidate) const
+        {
+            const auto n = intervals_.size();
+            if (n == 0)
+                return;
+
+            struct frame
+            {
+                int level;
+                size_type index;
+                bool left_done;
+            };
+            frame stack[64];
+            int top = 0;
+            stack[top++] = frame{max_level_, (size_type{1} << max_level_) - 1, false};
+
+            while (top != 0)
+            {
+                const frame current = stack[--top];
+                if (current.level <= 3)
+                {
+                    // Small subtrees are scanned linearly, they are only a few cache lines.
+                    const size_type first = current.index >> current.level << current.level;
+                    const size_type last = std::min(first + (size_type{1} << (current.level + 1)) - 1, n);
+                    for (size_type i = first; i < last && !past_end(intervals_[i]); ++i)
+                    {
+                        if (!on_candidate(i))
+                            return;
+                    }
+                }
+                else if (!current.left_done)
+                {
+                    const size_type left = current.index - (size_type{1} << (current.level - 1));
+                    stack[top++] = frame{current.level, current.index, true};
+                    if (left >= n || descend(max_[left]))
+                        stack[top++] = frame{current.level - 1, left, false};
+                }
+                else if (current.index < n && !past_end(intervals_[current.index]))
+                {
+                    if (!on_candidate(current.index))
+                        return;
+                    const size_type right = current.index + (size_type{1} << (current.level - 1));
+                    stack[top++] = frame{current.level - 1, right, false};
+                }
+            }
+        }
+
+      private:
+        interval_storage intervals_;
+        max_storage max_;
+        int max_level_;
+    };
+}
@@ -0,0 +1,188 @@
+#pragma once
+
+#include "interval_tree.hpp"
+
+#include <algorithm>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace lib_interval_tree
+{
+    namespace detail
+    {
+        /**
+         *  The intervals of one input that later intervals of the other input can still overlap.
+         */
+        template <typename interval_type>
+        class sweep_active_set
+        {
+          public:
+            /**
+             *  Adds ival. If the set doubled since it was last swept, dead intervals are dropped first,
+             *  so a long run of one input does not pile up intervals that no longer matter.
+             */
+            template <typename IsDeadFunctionT>
+            void add(interval_type const& ival, IsDeadFunctionT const& is_dead)
+            {
+                if (intervals_.size() >= std::max<std::size_t>(2 * swept_size_, 64))
+                {
+                    sweep(is_dead, [](interval_type const&) {
+                        return true;
+                    });
+                }
+                intervals_.push_back(ival);
+            }
+
+            /**
+             *  Drops the intervals that are dead as soon as the sweep reaches low, and calls on_alive for the rest.
+             *  Dropping swaps with the last interval, so the order of the set is not kept.
+             */
+            template <typename IsDeadFunctionT, typename FunctionT>
+            bool sweep(IsDeadFunctionT const& is_dead, FunctionT const& on_alive)
+            {
+                for (std::size_t i = 0; i < intervals_.size();)
+                {
+                    if (is_dead(intervals_[i]))
+                    {
+                        intervals_[i] = intervals_.back();
+                        intervals_.pop_back();
+                        continue;
+                    }
+                    if (!on_alive(intervals_[i]))
+                        return false;
+                    ++i;
+                }
+                swept_size_ = intervals_.size();
+                return true;
+            }
+
+          private:
+            std::vector<interval_type> intervals_;
+            std::size_t swept_size_ = 0;
+        };
+
+        /**
+         *  Taken from operator* rather than iterator_traits, so the iterators of interval_tree can be swept too.
+         */
+        template <typename IteratorT>
+        using sweep_interval_type = typename std::decay<decltype(*std::declval<IteratorT const&>())>::type;
+
+        template <bool Exclusive, typename interval_type>
+        bool sweep_overlaps(interval_type const& a, interval_type const& b)
+        {
+#if __cplusplus >= 201703L
+            if constexpr (Exclusive)
+#else
+            if (Exclusive)
+#endif
+                return a.overlaps_exclusive(b);
+            else
+                return a.overlaps(b);
+        }
+
+        template <bool Exclusive, typename InputIteratorA, typename InputIteratorB, typename FunctionT>
+        void sweep_overlap_join(
+            InputIteratorA first_a,
+            InputIteratorA last_a,
+            InputIteratorB first_b,
+            InputIteratorB last_b,
+            FunctionT const& on_pair
+        )
+        {
+            using interval_type = sweep_interval_type<InputIteratorA>;
+            using bounds = overlap_bounds<interval_type>;
+
+            sweep_active_set<interval_type> active_a;
+            sweep_active_set<interval_type> active_b;
+            bool has_previous_a = false;
+            bool has_previous_b = false;
+            typename interval_type::value_type previous_a{};
+            typename interval_type::value_type previous_b{};
+
+            const auto check_order = [](bool& has_previous, typename interval_type::value_type& previous, auto low) {
+                if (has_previous && low < previous)
+                    throw std::invalid_argument("sweep_overlap_join requires inputs sorted by low");
+                has_previous = true;
+                previous = low;
+            };
+
+            while (first_a != last_a || first_b != last_b)
+            {
+                // Ties go to a, either way every pair is tested once, when its later interval arrives.
+                if (first_b == last_b || (first_a != last_a && !((*first_b).low() < (*first_a).low())))
+                {
+                    const interval_type a = *first_a;
+                    ++first_a;
+                    check_order(has_previous_a, previous_a, a.low());
+                    // Every interval that arrives from now on starts at a.low() or later.
+                    const auto b_is_dead = [&a](interval_type const& b) {
+                        return !bounds::low_reaches_high(a.low(), b.high());
+                    };
+                    const auto a_is_dead = [&a](interval_type const& earlier) {
+                        return !bounds::high_reaches_low(earlier.high(), a.low());
+                    };
+                    const bool proceed = active_b.sweep(b_is_dead, [&a, &on_pair](interval_type const& b) {
+                        return !sweep_overlaps<Exclusive>(a, b) || on_pair(a, b);
+                    });
+                    if (!proceed)
+                        return;
+                    active_a.add(a, a_is_dead);
+                }
+                else
+                {
+                    const interval_type b = *first_b;
+                    ++first_b;
+                    check_order(has_previous_b, previous_b, b.low());
+                    const auto a_is_dead = [&b](interval_type const& a) {
+                        return !bounds::high_reaches_low(a.high(), b.low());
+                    };
+                    const auto b_is_dead = [&b](interval_type const& earlier) {
+                        return !bounds::low_reaches_high(b.low(), earlier.high());
+                    };
+                    const bool proceed = active_a.sweep(a_is_dead, [&b, &on_pair](interval_type const& a) {
+                        return !sweep_overlaps<Exclusive>(a, b) || on_pair(a, b);
+                    });
+                    if (!proceed)
+                        return;
+                    active_b.add(b, b_is_dead);
+                }
+            }
+        }
+    }
+    // ############################################################################################################
+    /**
+     *  Calls on_pair(a, b) for every interval a of [first_a, last_a) that overlaps an interval b of [first_b, last_b),
+     *  which are the same pairs that overlap_join of two trees reports. Both inputs have to be sorted by low, they are
+     *  read once from front to back, so plain input iterators over a stream are enough.
+     *
+     *  Only the intervals that can still overlap an upcoming interval of the other input are kept in memory.
+     *  For custom interval types, the intervals of b are only dropped at the end, because overlaps may be redefined.
+     *
+     *  @param on_pair A function of type bool(interval_type const& a, interval_type const& b). Return false to stop.
+     *  @param exclusive Exclude edges?
+     *  @throws std::invalid_argument if an input is not sorted by low. Pairs found up to there were reported.
+     */
+    template <typename InputIteratorA, typename InputIteratorB, typename FunctionT>
+    void sweep_overlap_join(
+        InputIteratorA first_a,
+        InputIteratorA last_a,
+        InputIteratorB first_b,
+        InputIteratorB last_b,
+        FunctionT const& on_pair,
+        bool exclusive = false
+    )
+    {
+        using interval_type_a = detail::sweep_interval_type<InputIteratorA>;
+        using interval_type_b = detail::sweep_interval_type<InputIteratorB>;
+        static_assert(
+            std::is_same<interval_type_a, interval_type_b>::value, "Both inputs need to have the same interval type."
+        );
+        if (exclusive)
+            detail::sweep_overlap_join<true>(first_a, last_a, first_b, last_b, on_pair);
+        else
+            detail::sweep_overlap_join<false>(first_a, last_a, first_b, last_b, on_pair);
+    }
+}
@@ -7,6 +7,14 @@ namespace lib_interval_tree
         struct no_hook_state
         {};
 
+        /**
+         *  Hooks are static functions that get called by the tree, derive from regular and hide the ones you need.
+         *
+         *  Hooks that get the tree as const (on_find, on_find_all, on_overlap_find, on_overlap_find_all, on_stab)
+         *  are called by searches. Searches may run on several threads at once, parallel_overlap_find_batch does so
+         *  itself. These hooks have to be thread safe then, for example by using atomics for counters in hook_state.
+         *  All other hooks are only called by modifications, which are never concurrent.
+         */
         struct regular
         {
             using node_type = void;
@@ -82,6 +90,41 @@ namespace lib_interval_tree
             static inline void
             on_overlap_find_all(tree_type const&, typename tree_type::node_type*, typename tree_type::interval_type const&) noexcept
             {}
+
+            template <typename tree_type>
+            static inline void
+            on_stab(tree_type const&, typename tree_type::node_type*, typename tree_type::value_type const&) noexcept
+            {}
+        };
+
+        /**
+         *  The hooks of base_hooks, but with a different node type.
+         */
+        template <typename node_type_, typename base_hooks = regular>
+        struct with_node_type : base_hooks
+        {
+            using node_type = node_type_;
+        };
+
+        /**
+         *  The hooks of base_hooks, with an aggregate of augmentation_ kept for every subtree.
+         *
+         *  augmentation_ is a monoid over intervals:
+         *  - value_type: the type of the aggregate.
+         *  - static value_type identity(): the aggregate of no intervals.
+         *  - static value_type from_interval(interval_type const&): the aggregate of one interval.
+         *  - static value_type combine(value_type const& left, value_type const& right): joins the aggregates of
+         *    two neighbouring ranges, left holds the smaller lows. It has to be associative and must not throw.
+         *  Instead of combine, an augmentation can have static value_type from_node(node_type const&), which computes
+         *  the aggregate of a node from its interval and its children, like augmentations::union_measure. Such
+         *  augmentations cannot be folded.
+         *
+         *  The nodes become augmented_node, unless base_hooks names a node type, which then has to derive from it.
+         */
+        template <typename augmentation_, typename base_hooks = regular>
+        struct with_augmentation : base_hooks
+        {
+            using augmentation = augmentation_;
         };
     }
 }
\ No newline at end of file
@@ -0,0 +1,221 @@
+#pragma once
+
+#include "test_utility.hpp"
+
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+
+struct AllocationCounter
+{
+    int allocations{0};
+    int deallocations{0};
+
+    int live() const
+    {
+        return allocations - deallocations;
+    }
+};
+
+template <typename T, bool Propagate = false>
+struct CountingAllocator
+{
+    using value_type = T;
+    using propagate_on_container_copy_assignment = std::integral_constant<bool, Propagate>;
+    using propagate_on_container_move_assignment = std::integral_constant<bool, Propagate>;
+    using is_always_equal = std::false_type;
+
+    template <typename U>
+    struct rebind
+    {
+        using other = CountingAllocator<U, Propagate>;
+    };
+
+    explicit CountingAllocator(AllocationCounter* counter)
+        : counter{counter}
+    {}
+
+    template <typename U>
+    CountingAllocator(CountingAllocator<U, Propagate> const& other)
+        : counter{other.counter}
+    {}
+
+    T* allocate(std::size_t n)
+    {
+        ++counter->allocations;
+        return std::allocator<T>{}.allocate(n);
+    }
+
+    void deallocate(T* p, std::size_t n)
+    {
+        ++counter->deallocations;
+        std::allocator<T>{}.deallocate(p, n);
+    }
+
+    template <typename U>
+    friend bool operator==(CountingAllocator const& lhs, CountingAllocator<U, Propagate> const& rhs)
+    {
+        return lhs.counter == rhs.counter;
+    }
+
+    template <typename U>
+    friend bool operator!=(CountingAllocator const& lhs, CountingAllocator<U, Propagate> const& rhs)
+    {
+        return lhs.counter != rhs.counter;
+    }
+
+    AllocationCounter* counter;
+};
+
+class AllocatorTests : public ::testing::Test
+{
+  public:
+    using interval_type = lib_interval_tree::interval<int>;
+
+    template <bool Propagate>
+    using tree_type = lib_interval_tree::
+        interval_tree<interval_type, lib_interval_tree::hooks::regular, CountingAllocator<interval_type, Propagate>>;
+
+  protected:
+    AllocationCounter counterA;
+    AllocationCounter counterB;
+};
+
+TEST_F(AllocatorTests, NodesAreAllocatedThroughAllocator)
+{
+    tree_type<false> tree{CountingAllocator<interval_type>{&counterA}};
+    for (int i = 0; i < 100; ++i)
+        tree.insert({i, i + 5});
+
+    EXPECT_EQ(counterA.allocations, 100);
+    EXPECT_EQ(counterA.live(), 100);
+
+    tree.erase(tree.begin());
+    EXPECT_EQ(counterA.live(), 99);
+
+    tree.clear();
+    EXPECT_EQ(counterA.live(), 0);
+    EXPECT_EQ(counterA.allocations, 100);
+}
+
+TEST_F(AllocatorTests, DestructorReleasesAllNodes)
+{
+    {
+        tree_type<false> tree{CountingAllocator<interval_type>{&counterA}};
+        for (int i = 0; i < 50; ++i)
+            tree.insert({i, i * 2});
+    }
+    EXPECT_EQ(counterA.allocations, 50);
+    EXPECT_EQ(counterA.live(), 0);
+}
+
+TEST_F(AllocatorTests, GetAllocatorReturnsConstructionAllocator)
+{
+    tree_type<false> tree{CountingAllocator<interval_type>{&counterA}};
+    EXPECT_EQ(tree.get_allocator().counter, &counterA);
+}
+
+TEST_F(AllocatorTests, CopyConstructionUsesCopiedAllocator)
+{
+    tree_type<false> tree{CountingAllocator<interval_type>{&counterA}};
+    tree.insert({0, 5});
+    tree.insert({3, 8});
+
+    auto copy = tree;
+    EXPECT_EQ(copy.get_allocator().counter, &counterA);
+    EXPECT_EQ(counterA.live(), 4);
+    EXPECT_EQ(copy.size(), 2);
+}
+
+TEST_F(AllocatorTests, CopyAssignmentKeepsAllocatorIfNotPropagating)
+{
+    tree_type<false> source{CountingAllocator<interval_type>{&counterA}};
+    source.insert({0, 5});
+    source.insert({3, 8});
+
+    tree_type<false> target{CountingAllocator<interval_type>{&counterB}};
+    target.insert({10, 20});
+    target = source;
+
+    EXPECT_EQ(target.get_allocator().counter, &counterB);
+    EXPECT_EQ(counterA.live(), 2);
+    EXPECT_EQ(counterB.live(), 2);
+    EXPECT_EQ(target.size(), 2);
+}
+
+TEST_F(AllocatorTests, CopyAssignmentPropagatesAllocator)
+{
+    tree_type<true> source{CountingAllocator<interval_type, true>{&counterA}};
+    source.insert({0, 5});
+
+    tree_type<true> target{CountingAllocator<interval_type, true>{&counterB}};
+    target.insert({10, 20});
+    target = source;
+
+    EXPECT_EQ(target.get_allocator().counter, &counterA);
+    EXPECT_EQ(counterA.live(), 2);
+    EXPECT_EQ(counterB.live(), 0);
+}
+
+TEST_F(AllocatorTests, MoveAssignmentPropagatesAllocator)
+{
+    tree_type<true> source{CountingAllocator<interval_type, true>{&counterA}};
+    source.insert({0, 5});
+    source.insert({1, 2});
+
+    tree_type<true> target{CountingAllocator<interval_type, true>{&counterB}};
+    target.insert({10, 20});
+    target = std::move(source);
+
+    EXPECT_EQ(target.get_allocator().counter, &counterA);
+    EXPECT_EQ(target.size(), 2);
+    EXPECT_EQ(source.size(), 0);
+    EXPECT_EQ(counterA.allocations, 2);
+    EXPECT_EQ(counterA.live(), 2);
+    EXPECT_EQ(counterB.live(), 0);
+}
+
+TEST_F(AllocatorTests, MoveAssignmentWithUnequalAllocatorsMovesElementWise)
+{
+    tree_type<false> source{CountingAllocator<interval_type>{&counterA}};
+    source.insert({0, 5});
+    source.insert({1, 2});
+
+    tree_type<false> target{CountingAllocator<interval_type>{&counterB}};
+    target = std::move(source);
+
+    EXPECT_EQ(target.get_allocator().counter, &counterB);
+    EXPECT_EQ(target.size(), 2);
+    EXPECT_EQ(source.size(), 0);
+    EXPECT_EQ(counterA.live(), 0);
+    EXPECT_EQ(counterB.live(), 2);
+    testMaxProperty(target);
+    testRedBlackPropertyViolation(target);
+}
+
+TEST_F(AllocatorTests, MoveConstructionStealsNodes)
+{
+    tree_type<false> source{CountingAllocator<interval_type>{&counterA}};
+    source.insert({0, 5});
+    source.insert({1, 2});
+
+    auto target = std::move(source);
+
+    EXPECT_EQ(target.get_allocator().counter, &counterA);
+    EXPECT_EQ(counterA.allocations, 2);
+    EXPECT_EQ(target.size(), 2);
+}
+
+TEST_F(AllocatorTests, DeoverlapUsesTreeAllocator)
+{
+    tree_type<false> tree{CountingAllocator<interval_type>{&counterA}};
+    tree.insert({0, 5});
+    tree.insert({3, 8});
+    tree.insert({20, 30});
+
+    tree.deoverlap();
+
+    EXPECT_EQ(tree.size(), 2);
+    EXPECT_EQ(tree.get_allocator().counter, &counterA);
+    EXPECT_EQ(counterA.live(), 2);
+}
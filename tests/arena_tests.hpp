@@ -0,0 +1,185 @@
+#pragma once
+
+#include <interval-tree/arena_allocator.hpp>
+
+#include "test_utility.hpp"
+
+#include <random>
+
+class ArenaTests : public ::testing::Test
+{
+  public:
+    using interval_type = lib_interval_tree::interval<int>;
+    using allocator_type = lib_interval_tree::arena_allocator<interval_type>;
+    using tree_type =
+        lib_interval_tree::interval_tree<interval_type, lib_interval_tree::hooks::regular, allocator_type>;
+
+  protected:
+    std::default_random_engine gen;
+    std::uniform_int_distribution<int> distLarge{-50000, 50000};
+};
+
+TEST_F(ArenaTests, SlabArenaReusesFreedBlocks)
+{
+    lib_interval_tree::slab_arena arena;
+    auto* a = arena.allocate(24, 8);
+    auto* b = arena.allocate(24, 8);
+    EXPECT_NE(a, b);
+    EXPECT_EQ(arena.live_blocks(), 2);
+
+    arena.deallocate(a);
+    EXPECT_EQ(arena.live_blocks(), 1);
+    EXPECT_EQ(arena.allocate(24, 8), a);
+    EXPECT_EQ(arena.slab_count(), 1);
+}
+
+TEST_F(ArenaTests, SlabArenaGrowsBySlabs)
+{
+    lib_interval_tree::arena_options options;
+    options.slab_bytes = 256;
+    lib_interval_tree::slab_arena arena{options};
+    for (int i = 0; i < 100; ++i)
+        arena.allocate(32, 8);
+    EXPECT_GT(arena.slab_count(), 1);
+
+    arena.release();
+    EXPECT_EQ(arena.slab_count(), 0);
+    EXPECT_EQ(arena.live_blocks(), 0);
+}
+
+TEST_F(ArenaTests, TreeWorksOnArena)
+{
+    tree_type tree;
+    for (int i = 0; i < 1000; ++i)
+        tree.insert(lib_interval_tree::make_safe_interval(distLarge(gen), distLarge(gen)));
+
+    EXPECT_EQ(tree.size(), 1000);
+    EXPECT_EQ(tree.get_allocator().arena().live_blocks(), 1000);
+    testMaxProperty(tree);
+    testRedBlackPropertyViolation(tree);
+
+    for (int i = 0; i < 500; ++i)
+        tree.erase(tree.begin());
+
+    EXPECT_EQ(tree.size(), 500);
+    EXPECT_EQ(tree.get_allocator().arena().live_blocks(), 500);
+    testMaxProperty(tree);
+}
+
+TEST_F(ArenaTests, ClearReleasesAllSlabsAtOnce)
+{
+    tree_type tree;
+    for (int i = 0; i < 10000; ++i)
+        tree.insert({i, i + 10});
+    EXPECT_GT(tree.get_allocator().arena().slab_count(), 1);
+
+    tree.clear();
+    EXPECT_TRUE(tree.empty());
+    EXPECT_EQ(tree.get_allocator().arena().slab_count(), 0);
+
+    tree.insert({1, 2});
+    EXPECT_EQ(tree.size(), 1);
+    EXPECT_EQ(tree.get_allocator().arena().live_blocks(), 1);
+}
+
+TEST_F(ArenaTests, SharedArenaIsNotReleasedByOneTree)
+{
+    allocator_type allocator;
+    tree_type a{allocator};
+    tree_type b{allocator};
+
+    for (int i = 0; i < 100; ++i)
+    {
+        a.insert({i, i + 1});
+        b.insert({i, i + 2});
+    }
+    a.clear();
+
+    EXPECT_EQ(b.size(), 100);
+    EXPECT_EQ(b.get_allocator().arena().live_blocks(), 100);
+    int i = 0;
+    for (auto const& ival : b)
+    {
+        EXPECT_EQ(ival.low(), i);
+        EXPECT_EQ(ival.high(), i + 2);
+        ++i;
+    }
+}
+
+TEST_F(ArenaTests, CopyGetsOwnArena)
+{
+    tree_type tree;
+    for (int i = 0; i < 100; ++i)
+        tree.insert({i, i + 1});
+
+    auto copy = tree;
+    EXPECT_NE(copy.get_allocator(), tree.get_allocator());
+    EXPECT_EQ(copy.get_allocator().arena().live_blocks(), 100);
+
+    tree.clear();
+    EXPECT_EQ(copy.size(), 100);
+    EXPECT_EQ(copy.begin()->low(), 0);
+}
+
+TEST_F(ArenaTests, MoveAssignmentTakesArena)
+{
+    tree_type tree;
+    for (int i = 0; i < 100; ++i)
+        tree.insert({i, i + 1});
+    auto allocator = tree.get_allocator();
+
+    tree_type other;
+    other.insert({5, 6});
+    other = std::move(tree);
+
+    EXPECT_EQ(other.get_allocator(), allocator);
+    EXPECT_EQ(other.size(), 100);
+}
+
+TEST_F(ArenaTests, MovedToTreeStillClearsInBulk)
+{
+    tree_type tree;
+    for (int i = 0; i < 10000; ++i)
+        tree.insert({i, i + 10});
+    auto const* arena = &tree.get_allocator().arena();
+
+    tree_type moved{std::move(tree)};
+    EXPECT_EQ(&moved.get_allocator().arena(), arena);
+    EXPECT_NE(moved.get_allocator(), tree.get_allocator());
+
+    moved.clear();
+    EXPECT_EQ(arena->slab_count(), 0);
+
+    tree.insert({1, 2});
+    EXPECT_EQ(tree.size(), 1);
+    EXPECT_EQ(tree.get_allocator().arena().live_blocks(), 1);
+}
+
+TEST_F(ArenaTests, MoveAssignedTreeStillClearsInBulk)
+{
+    tree_type tree;
+    for (int i = 0; i < 10000; ++i)
+        tree.insert({i, i + 10});
+    auto const* arena = &tree.get_allocator().arena();
+
+    tree_type other;
+    other = std::move(tree);
+
+    other.clear();
+    EXPECT_EQ(arena->slab_count(), 0);
+
+    tree.insert({1, 2});
+    EXPECT_EQ(tree.size(), 1);
+}
+
+TEST_F(ArenaTests, HugePageArenaWorks)
+{
+    lib_interval_tree::arena_options options;
+    options.huge_pages = true;
+    tree_type tree{allocator_type{options}};
+    for (int i = 0; i < 1000; ++i)
+        tree.insert({i, i + 1});
+
+    EXPECT_EQ(tree.size(), 1000);
+    testMaxProperty(tree);
+}
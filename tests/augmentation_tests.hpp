@@ -0,0 +1,175 @@
+#pragma once
+
+#include "test_utility.hpp"
+
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+class AugmentationTests : public ::testing::Test
+{
+  public:
+    using interval_type = lib_interval_tree::interval<int>;
+
+    template <typename augmentation>
+    using augmented_tree = lib_interval_tree::interval_tree<
+        interval_type,
+        lib_interval_tree::hooks::with_augmentation<augmentation>>;
+
+    // Not commutative, so folds in the wrong order show.
+    struct concatenation
+    {
+        using value_type = std::string;
+
+        static value_type identity()
+        {
+            return {};
+        }
+
+        static value_type from_interval(interval_type const& ival)
+        {
+            return std::to_string(ival.low()) + ";";
+        }
+
+        static value_type combine(value_type const& left, value_type const& right)
+        {
+            return left + right;
+        }
+    };
+
+  protected:
+    template <typename tree_type>
+    static int bruteForceSize(tree_type const& tree, int from, int to)
+    {
+        int result = 0;
+        for (auto const& ival : tree)
+        {
+            if (from <= ival.low() && ival.low() <= to)
+                result += ival.size();
+        }
+        return result;
+    }
+
+    template <typename tree_type>
+    static std::string bruteForceLows(tree_type const& tree, int from, int to)
+    {
+        std::string result;
+        for (auto const& ival : tree)
+        {
+            if (from <= ival.low() && ival.low() <= to)
+                result += std::to_string(ival.low()) + ";";
+        }
+        return result;
+    }
+
+    std::default_random_engine gen;
+    std::uniform_int_distribution<int> distValue{0, 1000};
+    std::uniform_int_distribution<int> distLength{0, 50};
+};
+
+TEST_F(AugmentationTests, FoldMatchesBruteForceWhileInsertingAndErasing)
+{
+    augmented_tree<lib_interval_tree::augmentations::total_size<int>> tree;
+    for (int i = 0; i < 3000; ++i)
+    {
+        const int low = distValue(gen);
+        tree.insert({low, low + distLength(gen)});
+        if (i % 3 == 0)
+        {
+            const int probe = distValue(gen);
+            auto iter = tree.overlap_find({probe, probe + 10});
+            if (iter != tree.end())
+                tree.erase(iter);
+        }
+        if (i % 50 == 0)
+        {
+            const int from = distValue(gen);
+            const int to = from + distValue(gen) / 4;
+            EXPECT_EQ(tree.fold(from, to), bruteForceSize(tree, from, to));
+            EXPECT_EQ(tree.fold(), bruteForceSize(tree, 0, 2000));
+        }
+    }
+    testMaxProperty(tree);
+}
+
+TEST_F(AugmentationTests, FoldCombinesInAscendingOrderOfLow)
+{
+    augmented_tree<concatenation> tree;
+    for (int i = 0; i < 500; ++i)
+        tree.insert({distValue(gen), 2000});
+    for (int i = 0; i < 200; ++i)
+    {
+        auto iter = tree.begin();
+        for (int skip = distValue(gen) % 100; skip != 0; --skip)
+            ++iter;
+        tree.erase(iter);
+    }
+    EXPECT_EQ(tree.fold(), bruteForceLows(tree, 0, 1000));
+    for (int i = 0; i < 100; ++i)
+    {
+        const int from = distValue(gen);
+        const int to = from + distValue(gen) / 2;
+        EXPECT_EQ(tree.fold(from, to), bruteForceLows(tree, from, to));
+    }
+    EXPECT_EQ(tree.fold(1001, 2000), "");
+    EXPECT_EQ(tree.fold(10, 5), "");
+}
+
+TEST_F(AugmentationTests, AggregatesSurviveBulkConstructionAndCopies)
+{
+    std::vector<interval_type> intervals;
+    for (int i = 0; i < 1000; ++i)
+    {
+        const int low = distValue(gen);
+        intervals.push_back({low, low + distLength(gen)});
+    }
+
+    augmented_tree<lib_interval_tree::augmentations::count<>> tree;
+    tree.assign_unsorted(intervals.begin(), intervals.begin() + 600);
+    EXPECT_EQ(tree.fold(), 600u);
+    tree.insert_bulk(intervals.begin() + 600, intervals.end());
+    EXPECT_EQ(tree.fold(), 1000u);
+
+    const auto copy = tree;
+    std::size_t expected = 0;
+    for (auto const& ival : intervals)
+        expected += ival.low() >= 100 && ival.low() <= 300;
+    EXPECT_EQ(copy.fold(100, 300), expected);
+    EXPECT_EQ(tree.fold(100, 300), expected);
+}
+
+TEST_F(AugmentationTests, MinHighOfRange)
+{
+    augmented_tree<lib_interval_tree::augmentations::min_high<int>> tree;
+    EXPECT_EQ(tree.fold(), std::numeric_limits<int>::max());
+    tree.insert({0, 100});
+    tree.insert({10, 20});
+    tree.insert({30, 35});
+    tree.insert({40, 90});
+
+    EXPECT_EQ(tree.fold(), 20);
+    EXPECT_EQ(tree.fold(11, 50), 35);
+    EXPECT_EQ(tree.fold(0, 9), 100);
+}
+
+TEST_F(AugmentationTests, IndexLinkedNodesCanBeAugmented)
+{
+    using augmentation = lib_interval_tree::augmentations::count<>;
+    using tree_type = lib_interval_tree::interval_tree<
+        interval_type,
+        lib_interval_tree::hooks::with_node_type<
+            lib_interval_tree::augmented_node<int, interval_type, augmentation, void, lib_interval_tree::index_links>,
+            lib_interval_tree::hooks::with_augmentation<augmentation>>>;
+
+    tree_type tree;
+    for (int i = 0; i < 500; ++i)
+        tree.insert({i, i + 1});
+    for (int i = 0; i < 500; i += 2)
+        tree.erase(tree.find({i, i + 1}));
+    EXPECT_EQ(tree.fold(), 250u);
+    EXPECT_EQ(tree.fold(100, 199), 50u);
+
+    const auto copy = tree;
+    EXPECT_EQ(copy.fold(0, 99), 50u);
+}
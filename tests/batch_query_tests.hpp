@@ -0,0 +1,316 @@
+#pragma once
+
+#include <interval-tree/interval_tree_parallel.hpp>
+
+#include "test_utility.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <random>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+class BatchQueryTests : public ::testing::Test
+{
+  public:
+    using interval_type = lib_interval_tree::interval<int>;
+    using tree_type = lib_interval_tree::interval_tree_t<int>;
+
+  protected:
+    void fill(tree_type& tree, int count)
+    {
+        for (int i = 0; i < count; ++i)
+        {
+            const auto low = distValue(gen);
+            tree.insert({low, low + distLength(gen)});
+        }
+    }
+
+    std::vector<interval_type> makeQueries(int count)
+    {
+        std::vector<interval_type> queries;
+        for (int i = 0; i < count; ++i)
+        {
+            const auto low = distValue(gen);
+            queries.push_back({low, low + distLength(gen)});
+        }
+        return queries;
+    }
+
+    template <typename TreeT>
+    static std::vector<std::vector<std::pair<int, int>>>
+    runBatch(TreeT const& tree, std::vector<interval_type> const& queries, bool exclusive)
+    {
+        std::vector<std::vector<std::pair<int, int>>> results(queries.size());
+        tree.overlap_find_batch(
+            queries,
+            [&results](std::size_t query, auto iter) {
+                results[query].emplace_back(iter->low(), iter->high());
+                return true;
+            },
+            exclusive
+        );
+        for (auto& result : results)
+            std::sort(result.begin(), result.end());
+        return results;
+    }
+
+    template <typename TreeT>
+    static std::vector<std::vector<std::pair<int, int>>>
+    runSingle(TreeT const& tree, std::vector<interval_type> const& queries, bool exclusive)
+    {
+        std::vector<std::vector<std::pair<int, int>>> results(queries.size());
+        for (std::size_t i = 0; i != queries.size(); ++i)
+        {
+            tree.overlap_find_all(
+                queries[i],
+                [&results, i](auto iter) {
+                    results[i].emplace_back(iter->low(), iter->high());
+                    return true;
+                },
+                exclusive
+            );
+            std::sort(results[i].begin(), results[i].end());
+        }
+        return results;
+    }
+
+    std::default_random_engine gen;
+    std::uniform_int_distribution<int> distValue{0, 100000};
+    std::uniform_int_distribution<int> distLength{0, 500};
+};
+
+TEST_F(BatchQueryTests, EmptyTreeAndEmptyBatch)
+{
+    tree_type tree;
+    int calls = 0;
+    const auto count = [&calls](std::size_t, auto) {
+        ++calls;
+        return true;
+    };
+    tree.overlap_find_batch(makeQueries(10), count);
+    fill(tree, 100);
+    tree.overlap_find_batch(std::vector<interval_type>{}, count);
+    EXPECT_EQ(calls, 0);
+}
+
+TEST_F(BatchQueryTests, MatchesSingleQueries)
+{
+    tree_type tree;
+    fill(tree, 5000);
+    const auto queries = makeQueries(1000);
+
+    for (bool exclusive : {false, true})
+        EXPECT_EQ(runBatch(tree, queries, exclusive), runSingle(tree, queries, exclusive));
+}
+
+TEST_F(BatchQueryTests, FewerQueriesThanSlots)
+{
+    tree_type tree;
+    fill(tree, 1000);
+    const auto queries = makeQueries(3);
+    EXPECT_EQ(runBatch(tree, queries, false), runSingle(tree, queries, false));
+}
+
+TEST_F(BatchQueryTests, StoppingOneQueryLeavesOthersRunning)
+{
+    tree_type tree;
+    for (int i = 0; i < 100; ++i)
+        tree.insert({0, 10});
+
+    const std::vector<interval_type> queries(40, interval_type{5, 5});
+    std::vector<int> counts(queries.size(), 0);
+    tree.overlap_find_batch(queries, [&counts](std::size_t query, tree_type::iterator) {
+        ++counts[query];
+        return query % 2 == 0 || counts[query] < 3;
+    });
+
+    for (std::size_t i = 0; i != counts.size(); ++i)
+        EXPECT_EQ(counts[i], i % 2 == 0 ? 100 : 3);
+}
+
+TEST_F(BatchQueryTests, WorksOnIndexLinkedTree)
+{
+    lib_interval_tree::index_linked_interval_tree_t<int> tree;
+    for (int i = 0; i < 3000; ++i)
+    {
+        const auto low = distValue(gen);
+        tree.insert({low, low + distLength(gen)});
+    }
+    const auto queries = makeQueries(500);
+    EXPECT_EQ(runBatch(tree, queries, false), runSingle(tree, queries, false));
+}
+
+TEST_F(BatchQueryTests, SortedBatchMatchesSingleQueries)
+{
+    tree_type tree;
+    fill(tree, 5000);
+    const auto queries = makeQueries(1000);
+
+    for (bool exclusive : {false, true})
+    {
+        std::vector<std::vector<std::pair<int, int>>> results(queries.size());
+        tree.overlap_find_batch_sorted(
+            queries,
+            [&results](std::size_t query, tree_type::iterator iter) {
+                results[query].emplace_back(iter->low(), iter->high());
+                return true;
+            },
+            exclusive
+        );
+        for (auto& result : results)
+            std::sort(result.begin(), result.end());
+        EXPECT_EQ(results, runSingle(tree, queries, exclusive));
+    }
+}
+
+TEST_F(BatchQueryTests, SortedBatchStopsSingleQueries)
+{
+    tree_type tree;
+    for (int i = 0; i < 100; ++i)
+        tree.insert({i, i + 10});
+
+    const std::vector<interval_type> queries{{50, 60}, {0, 200}, {55, 55}, {300, 400}};
+    std::vector<int> counts(queries.size(), 0);
+    [&](auto const& constTree) {
+        constTree.overlap_find_batch_sorted(queries, [&counts](std::size_t query, auto) {
+            ++counts[query];
+            return query != 1 || counts[query] < 5;
+        });
+    }(tree);
+
+    EXPECT_EQ(counts[0], 21);
+    EXPECT_EQ(counts[1], 5);
+    EXPECT_EQ(counts[2], 11);
+    EXPECT_EQ(counts[3], 0);
+}
+
+struct AtomicVisitCountingHook : public lib_interval_tree::hooks::regular
+{
+    struct hook_state
+    {
+        mutable std::atomic<long long> visits{0};
+    };
+
+    template <typename tree_type>
+    static inline void on_overlap_find_all(
+        tree_type const& tree,
+        typename tree_type::node_type*,
+        typename tree_type::interval_type const&
+    ) noexcept
+    {
+        tree.visits.fetch_add(1, std::memory_order_relaxed);
+    }
+};
+
+TEST_F(BatchQueryTests, ParallelBatchMatchesSingleQueries)
+{
+    tree_type tree;
+    fill(tree, 5000);
+    const auto queries = makeQueries(3000);
+
+    for (unsigned threads : {1u, 4u, 0u})
+    {
+        for (bool exclusive : {false, true})
+        {
+            std::vector<std::vector<interval_type>> results{{interval_type{1, 2}}};
+            lib_interval_tree::parallel_overlap_find_batch(tree, queries, results, threads, exclusive);
+            ASSERT_EQ(results.size(), queries.size());
+
+            std::vector<std::vector<std::pair<int, int>>> sortedResults(results.size());
+            for (std::size_t i = 0; i != results.size(); ++i)
+            {
+                for (auto const& ival : results[i])
+                    sortedResults[i].emplace_back(ival.low(), ival.high());
+                std::sort(sortedResults[i].begin(), sortedResults[i].end());
+            }
+            EXPECT_EQ(sortedResults, runSingle(tree, queries, exclusive));
+        }
+    }
+}
+
+TEST_F(BatchQueryTests, ParallelBatchCallsHooksFromAllThreads)
+{
+    lib_interval_tree::interval_tree<interval_type, AtomicVisitCountingHook> tree;
+    for (int i = 0; i < 5000; ++i)
+    {
+        const auto low = distValue(gen);
+        tree.insert({low, low + distLength(gen)});
+    }
+    const auto queries = makeQueries(3000);
+
+    std::vector<std::vector<interval_type>> results;
+    lib_interval_tree::parallel_overlap_find_batch(tree, queries, results, 1);
+    const auto serialVisits = tree.visits.load();
+    tree.visits = 0;
+    lib_interval_tree::parallel_overlap_find_batch(tree, queries, results, 8);
+    EXPECT_GT(serialVisits, 0);
+    EXPECT_EQ(tree.visits.load(), serialVisits);
+}
+
+TEST_F(BatchQueryTests, ParallelForCoversEveryIndexOnce)
+{
+    std::vector<std::atomic<int>> hits(10007);
+    lib_interval_tree::detail::parallel_for(hits.size(), 8, 13, [&hits](std::size_t first, std::size_t last) {
+        for (auto i = first; i != last; ++i)
+            ++hits[i];
+    });
+    for (auto const& hit : hits)
+        ASSERT_EQ(hit.load(), 1);
+}
+
+TEST_F(BatchQueryTests, ParallelForRethrowsExceptions)
+{
+    EXPECT_THROW(
+        lib_interval_tree::detail::parallel_for(
+            1000,
+            4,
+            10,
+            [](std::size_t first, std::size_t) {
+                if (first >= 500)
+                    throw std::runtime_error("failed");
+            }
+        ),
+        std::runtime_error
+    );
+}
+
+TEST_F(BatchQueryTests, ParallelSingleQueryMatchesSerial)
+{
+    tree_type tree;
+    fill(tree, 100000);
+
+    const std::vector<interval_type> queries{{0, 100000}, {20000, 70000}, {500, 600}, {200000, 300000}};
+    for (auto const& query : queries)
+    {
+        for (bool exclusive : {false, true})
+        {
+            for (unsigned threads : {1u, 4u})
+            {
+                std::vector<interval_type> results{{1, 2}};
+                lib_interval_tree::parallel_overlap_find_all(tree, query, results, threads, exclusive);
+
+                std::vector<std::pair<int, int>> found;
+                for (auto const& ival : results)
+                    found.emplace_back(ival.low(), ival.high());
+                std::sort(found.begin(), found.end());
+                EXPECT_EQ(found, runSingle(tree, {query}, exclusive)[0]);
+            }
+        }
+    }
+}
+
+TEST_F(BatchQueryTests, ParallelSingleQueryOnEmptyAndSmallTrees)
+{
+    tree_type tree;
+    std::vector<interval_type> results{{1, 2}};
+    lib_interval_tree::parallel_overlap_find_all(tree, {0, 10}, results, 4);
+    EXPECT_TRUE(results.empty());
+
+    tree.insert({0, 5});
+    tree.insert({3, 8});
+    tree.insert({20, 30});
+    lib_interval_tree::parallel_overlap_find_all(tree, {4, 10}, results, 4);
+    EXPECT_EQ(results.size(), 2);
+}
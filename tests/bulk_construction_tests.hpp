@@ -0,0 +1,201 @@
+#pragma once
+
+#include <interval-tree/interval_tree_parallel.hpp>
+
+#include "test_utility.hpp"
+
+#include <algorithm>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+class BulkConstructionTests : public ::testing::Test
+{
+  public:
+    using interval_type = lib_interval_tree::interval<int>;
+    using tree_type = lib_interval_tree::interval_tree_t<int>;
+
+  protected:
+    std::vector<interval_type> randomIntervals(int count)
+    {
+        std::vector<interval_type> result;
+        for (int i = 0; i < count; ++i)
+            result.push_back(lib_interval_tree::make_safe_interval(distLarge(gen), distLarge(gen)));
+        return result;
+    }
+
+    static void sortByLow(std::vector<interval_type>& intervals)
+    {
+        std::stable_sort(intervals.begin(), intervals.end(), [](auto const& lhs, auto const& rhs) {
+            return lhs.low() < rhs.low();
+        });
+    }
+
+    std::default_random_engine gen;
+    std::uniform_int_distribution<int> distLarge{-50000, 50000};
+};
+
+TEST_F(BulkConstructionTests, AssignBuildsValidTreeForAllSizes)
+{
+    for (int count = 0; count < 70; ++count)
+    {
+        auto intervals = randomIntervals(count);
+        sortByLow(intervals);
+
+        tree_type tree;
+        tree.assign(intervals.begin(), intervals.end());
+
+        ASSERT_EQ(tree.size(), count);
+        if (count == 0)
+        {
+            EXPECT_TRUE(tree.empty());
+            continue;
+        }
+        testMaxProperty(tree);
+        testRedBlackPropertyViolation(tree);
+        testTreeHeightHealth(tree);
+
+        auto iter = intervals.begin();
+        for (auto const& ival : tree)
+        {
+            EXPECT_EQ(ival, *iter);
+            ++iter;
+        }
+    }
+}
+
+TEST_F(BulkConstructionTests, AssignReplacesContent)
+{
+    tree_type tree;
+    tree.insert({1000, 2000});
+
+    std::vector<interval_type> intervals{{0, 5}, {1, 2}, {3, 9}};
+    tree.assign(intervals.begin(), intervals.end());
+
+    EXPECT_EQ(tree.size(), 3);
+    EXPECT_EQ(tree.overlap_find({1500, 1600}), tree.end());
+    EXPECT_NE(tree.overlap_find({8, 8}), tree.end());
+}
+
+TEST_F(BulkConstructionTests, AssignRejectsUnsortedRange)
+{
+    tree_type tree;
+    std::vector<interval_type> intervals{{5, 10}, {0, 3}};
+    EXPECT_THROW(tree.assign(intervals.begin(), intervals.end()), std::invalid_argument);
+}
+
+TEST_F(BulkConstructionTests, TreeStaysUsableAfterAssign)
+{
+    auto intervals = randomIntervals(1000);
+    sortByLow(intervals);
+
+    tree_type tree;
+    tree.assign(intervals.begin(), intervals.end());
+    for (int i = 0; i < 500; ++i)
+        tree.insert(lib_interval_tree::make_safe_interval(distLarge(gen), distLarge(gen)));
+    testMaxProperty(tree);
+    testRedBlackPropertyViolation(tree);
+
+    for (int i = 0; i < 700; ++i)
+        tree.erase(tree.begin());
+    EXPECT_EQ(tree.size(), 800);
+    testMaxProperty(tree);
+}
+
+TEST_F(BulkConstructionTests, AssignUnsortedSortsFirst)
+{
+    const auto intervals = randomIntervals(100000);
+    auto sorted = intervals;
+    sortByLow(sorted);
+
+    for (unsigned threads : {1u, 4u})
+    {
+        tree_type tree;
+        lib_interval_tree::parallel_assign_unsorted(tree, intervals.begin(), intervals.end(), threads);
+
+        ASSERT_EQ(tree.size(), 100000);
+        testMaxProperty(tree);
+
+        auto iter = sorted.begin();
+        for (auto const& ival : tree)
+        {
+            EXPECT_EQ(ival.low(), iter->low());
+            ++iter;
+        }
+    }
+}
+
+TEST_F(BulkConstructionTests, AssignWorksOnIndexLinkedTree)
+{
+    auto intervals = randomIntervals(5000);
+    sortByLow(intervals);
+
+    lib_interval_tree::index_linked_interval_tree_t<int> tree;
+    tree.insert({1, 2});
+    tree.assign(intervals.begin(), intervals.end());
+
+    EXPECT_EQ(tree.size(), 5000);
+    testMaxProperty(tree);
+    testRedBlackPropertyViolation(tree);
+}
+
+TEST_F(BulkConstructionTests, InsertBulkMergesBigBatches)
+{
+    auto existing = randomIntervals(2000);
+    sortByLow(existing);
+    tree_type tree;
+    tree.assign(existing.begin(), existing.end());
+    const auto kept = tree.begin();
+    const auto keptInterval = *kept;
+
+    const auto batch = randomIntervals(1500);
+    tree.insert_bulk(batch.begin(), batch.end());
+
+    ASSERT_EQ(tree.size(), 3500);
+    testMaxProperty(tree);
+    testRedBlackPropertyViolation(tree);
+    testTreeHeightHealth(tree);
+
+    // Nodes are relinked, not reallocated.
+    EXPECT_EQ(*kept, keptInterval);
+
+    auto all = existing;
+    all.insert(all.end(), batch.begin(), batch.end());
+    sortByLow(all);
+    auto iter = all.begin();
+    for (auto const& ival : tree)
+    {
+        EXPECT_EQ(ival, *iter);
+        ++iter;
+    }
+}
+
+TEST_F(BulkConstructionTests, InsertBulkInsertsSmallBatchesOneByOne)
+{
+    auto existing = randomIntervals(5000);
+    sortByLow(existing);
+    tree_type tree;
+    tree.assign(existing.begin(), existing.end());
+
+    const std::vector<interval_type> batch{{1, 2}, {-5, 3}, {7, 7}};
+    tree.insert_bulk(batch.begin(), batch.end());
+
+    EXPECT_EQ(tree.size(), 5003);
+    testMaxProperty(tree);
+    for (auto const& ival : batch)
+        EXPECT_NE(tree.find(ival), tree.end());
+}
+
+TEST_F(BulkConstructionTests, InsertBulkIntoEmptyTree)
+{
+    tree_type tree;
+    const auto batch = randomIntervals(300);
+    tree.insert_bulk(batch.begin(), batch.end());
+
+    EXPECT_EQ(tree.size(), 300);
+    testMaxProperty(tree);
+    testRedBlackPropertyViolation(tree);
+
+    tree.insert_bulk(batch.begin(), batch.begin());
+    EXPECT_EQ(tree.size(), 300);
+}
@@ -0,0 +1,165 @@
+#pragma once
+
+#include <interval-tree/concurrent_interval_tree.hpp>
+
+#include <algorithm>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// An interval that fails to be copied once it was copied twice, which is the copy the combiner makes.
+struct fragile_interval : public lib_interval_tree::interval<int>
+{
+    fragile_interval(int low, int high, bool fragile = false)
+        : lib_interval_tree::interval<int>{low, high}
+        , fragile{fragile}
+        , copies{0}
+    {}
+
+    fragile_interval(fragile_interval const& other)
+        : lib_interval_tree::interval<int>{other}
+        , fragile{other.fragile}
+        , copies{other.copies + 1}
+    {
+        if (fragile && other.copies >= 2)
+            throw std::runtime_error{"copy failed"};
+    }
+
+    fragile_interval& operator=(fragile_interval const&) = default;
+
+    bool fragile;
+    int copies;
+};
+
+class ConcurrentTreeTests : public ::testing::Test
+{
+  protected:
+    using interval_type = lib_interval_tree::interval<int>;
+    using concurrent_tree = lib_interval_tree::concurrent_interval_tree<interval_type>;
+
+    static std::vector<std::pair<int, int>> contents(concurrent_tree const& tree)
+    {
+        return tree.read([](concurrent_tree::tree_type const& inner) {
+            std::vector<std::pair<int, int>> result;
+            for (auto const& ival : inner)
+                result.emplace_back(ival.low(), ival.high());
+            return result;
+        });
+    }
+};
+
+TEST_F(ConcurrentTreeTests, InsertedIntervalsAreVisibleOnReturn)
+{
+    concurrent_tree tree;
+    tree.insert({5, 10});
+    tree.insert({0, 3});
+    tree.insert({8, 20});
+
+    EXPECT_EQ(tree.size(), 3);
+    EXPECT_EQ(contents(tree), (std::vector<std::pair<int, int>>{{0, 3}, {5, 10}, {8, 20}}));
+
+    std::vector<std::pair<int, int>> found;
+    tree.overlap_find_all({9, 9}, [&found](concurrent_tree::tree_type::const_iterator iter) {
+        found.emplace_back(iter->low(), iter->high());
+        return true;
+    });
+    std::sort(found.begin(), found.end());
+    EXPECT_EQ(found, (std::vector<std::pair<int, int>>{{5, 10}, {8, 20}}));
+}
+
+TEST_F(ConcurrentTreeTests, EraseReportsWhetherAnIntervalWasErased)
+{
+    concurrent_tree tree;
+    tree.insert({1, 2});
+    tree.insert({1, 2});
+
+    EXPECT_TRUE(tree.erase({1, 2}));
+    EXPECT_FALSE(tree.erase({1, 3}));
+    EXPECT_EQ(tree.size(), 1);
+    EXPECT_TRUE(tree.erase({1, 2}));
+    EXPECT_FALSE(tree.erase({1, 2}));
+    EXPECT_TRUE(tree.empty());
+}
+
+TEST_F(ConcurrentTreeTests, AsyncOperationsAreAppliedInOrder)
+{
+    concurrent_tree tree;
+    tree.insert_async({0, 1});
+    tree.erase_async({0, 1});
+    tree.insert_async({0, 1});
+    tree.insert_async({2, 3});
+    tree.erase_async({4, 5});
+    tree.flush();
+
+    EXPECT_EQ(contents(tree), (std::vector<std::pair<int, int>>{{0, 1}, {2, 3}}));
+}
+
+TEST_F(ConcurrentTreeTests, StartsFromGivenTree)
+{
+    concurrent_tree::tree_type initial;
+    initial.insert({0, 10});
+    concurrent_tree tree{std::move(initial)};
+    tree.insert({3, 4});
+
+    EXPECT_EQ(tree.size(), 2);
+}
+
+TEST_F(ConcurrentTreeTests, ConcurrentWritersAndReaders)
+{
+    concurrent_tree tree;
+
+    std::vector<std::thread> threads;
+    for (int writer = 0; writer < 4; ++writer)
+    {
+        threads.emplace_back([&tree, writer] {
+            for (int i = 0; i < 500; ++i)
+            {
+                const int low = writer * 1000 + i;
+                if (i % 2 == 0)
+                    tree.insert({low, low + 10});
+                else
+                    tree.insert_async({low, low + 10});
+                if (i % 3 == 0)
+                {
+                    EXPECT_TRUE(tree.erase({low, low + 10}));
+                }
+            }
+            tree.flush();
+        });
+    }
+    threads.emplace_back([&tree] {
+        for (int i = 0; i < 200; ++i)
+        {
+            const auto found = contents(tree);
+            EXPECT_TRUE(std::is_sorted(found.begin(), found.end()));
+        }
+    });
+    for (auto& thread : threads)
+        thread.join();
+
+    EXPECT_EQ(tree.size(), 4 * 333);
+    const auto found = contents(tree);
+    EXPECT_TRUE(std::adjacent_find(found.begin(), found.end()) == found.end());
+}
+
+TEST_F(ConcurrentTreeTests, FailuresOutsideOfAnOperationDoNotStopLaterWriters)
+{
+    lib_interval_tree::concurrent_interval_tree<fragile_interval> tree;
+
+    tree.insert_async({0, 1, true});
+    EXPECT_THROW(tree.flush(), std::runtime_error);
+    EXPECT_THROW(tree.insert({2, 3, true}), std::runtime_error);
+
+    std::vector<std::thread> threads;
+    for (int writer = 0; writer < 4; ++writer)
+    {
+        threads.emplace_back([&tree, writer] {
+            for (int i = 0; i < 100; ++i)
+                tree.insert({writer * 1000 + i, writer * 1000 + i + 1});
+        });
+    }
+    for (auto& thread : threads)
+        thread.join();
+    EXPECT_EQ(tree.size(), 4 * 100);
+}
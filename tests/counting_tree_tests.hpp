@@ -0,0 +1,82 @@
+#pragma once
+
+#include <interval-tree/counting_interval_tree.hpp>
+
+#include "test_utility.hpp"
+
+#include <random>
+#include <vector>
+
+class CountingTreeTests : public BruteForceTests
+{
+  protected:
+    CountingTreeTests()
+    {
+        distValue = std::uniform_int_distribution<int>{0, 500};
+    }
+
+    template <typename IntervalT, typename MakeIntervalT>
+    void compareWithBruteForce(MakeIntervalT const& makeInterval)
+    {
+        lib_interval_tree::counting_interval_tree<IntervalT> tree;
+        std::vector<IntervalT> intervals;
+        for (int i = 0; i < 2000; ++i)
+        {
+            intervals.push_back(makeInterval(distValue(gen), distLength(gen)));
+            tree.insert(intervals.back());
+            if (i % 4 == 0)
+            {
+                const auto victim = intervals.begin() + static_cast<std::ptrdiff_t>(gen() % intervals.size());
+                EXPECT_TRUE(tree.erase(*victim));
+                intervals.erase(victim);
+            }
+        }
+        EXPECT_EQ(tree.size(), intervals.size());
+        EXPECT_FALSE(tree.erase(makeInterval(-100, 0)));
+
+        for (int query = 0; query < 300; ++query)
+        {
+            // Every third query is a point, which touches the borders most.
+            const auto ival = makeInterval(distValue(gen), query % 3 == 0 ? 0 : distLength(gen));
+            for (bool exclusive : {false, true})
+                EXPECT_EQ(tree.overlap_count(ival, exclusive), bruteForceOverlaps(intervals, ival, exclusive).size());
+        }
+    }
+};
+
+TEST_F(CountingTreeTests, AllKindsMatchBruteForce)
+{
+    forEachStaticKind([this](auto kind) {
+        using interval_type = typename decltype(kind)::type;
+        compareWithBruteForce<interval_type>(intervalOfLength<interval_type>);
+    });
+}
+
+TEST_F(CountingTreeTests, PointIntervalsOnAPointQuery)
+{
+    using namespace lib_interval_tree;
+    counting_interval_tree<interval<int, open>> tree;
+    tree.insert({5, 5});
+    tree.insert({5, 5});
+    tree.insert({4, 6});
+    tree.insert({5, 9});
+
+    EXPECT_EQ(tree.overlap_count({5, 5}), 1);
+    EXPECT_EQ(tree.overlap_count({5, 5}, true), 1);
+    EXPECT_EQ(tree.overlap_count({0, 10}), 4);
+}
+
+TEST_F(CountingTreeTests, EmptyAndCleared)
+{
+    lib_interval_tree::counting_interval_tree<lib_interval_tree::interval<double>> tree;
+    EXPECT_EQ(tree.overlap_count({0.0, 1.0}), 0);
+    tree.insert({0.5, 1.5});
+    tree.insert({2.0, 3.0});
+    EXPECT_EQ(tree.overlap_count({1.5, 2.0}), 2);
+    EXPECT_EQ(tree.overlap_count({1.5, 2.0}, true), 0);
+    EXPECT_EQ(tree.tree().size(), 2);
+
+    tree.clear();
+    EXPECT_TRUE(tree.empty());
+    EXPECT_EQ(tree.overlap_count({0.0, 5.0}), 0);
+}
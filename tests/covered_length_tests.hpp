@@ -0,0 +1,107 @@
+#pragma once
+
+#include "test_utility.hpp"
+
+#include <algorithm>
+#include <random>
+#include <utility>
+#include <vector>
+
+class CoveredLengthTests : public BruteForceTests
+{
+  public:
+    template <typename IntervalT>
+    using tree_type = lib_interval_tree::interval_tree<
+        IntervalT,
+        lib_interval_tree::hooks::with_augmentation<
+            lib_interval_tree::augmentations::union_measure<typename IntervalT::value_type>>>;
+
+  protected:
+    CoveredLengthTests()
+    {
+        distValue = std::uniform_int_distribution<int>{0, 1000};
+        distLength = std::uniform_int_distribution<int>{0, 40};
+    }
+
+    // Counts the values in window that lie in any interval, which is what size() measures for integral intervals.
+    template <typename IntervalT>
+    static int bruteForce(std::vector<IntervalT> const& intervals, IntervalT const& window)
+    {
+        int result = 0;
+        for (int value = window.low(); value <= window.high(); ++value)
+        {
+            if (!window.within(value))
+                continue;
+            result += std::any_of(intervals.begin(), intervals.end(), [value](IntervalT const& ival) {
+                return ival.within(value);
+            });
+        }
+        return result;
+    }
+
+    template <typename IntervalT>
+    void compareWithBruteForce()
+    {
+        tree_type<IntervalT> tree;
+        std::vector<IntervalT> intervals;
+        for (int i = 0; i < 600; ++i)
+        {
+            const int low = distValue(gen);
+            intervals.push_back({low, low + distLength(gen)});
+            tree.insert(intervals.back());
+            if (i % 3 == 0)
+            {
+                const auto victim = intervals.begin() + static_cast<std::ptrdiff_t>(gen() % intervals.size());
+                tree.erase(tree.find(*victim));
+                intervals.erase(victim);
+            }
+            if (i % 20 == 0)
+            {
+                const int low = distValue(gen) - 20;
+                const IntervalT window{low, low + distValue(gen) / 2};
+                EXPECT_EQ(tree.covered_length(window), bruteForce(intervals, window));
+            }
+        }
+        EXPECT_EQ(tree.covered_length(), bruteForce(intervals, IntervalT{-100, 2000}));
+    }
+};
+
+TEST_F(CoveredLengthTests, AllKindsMatchBruteForce)
+{
+    forEachStaticKind([this](auto kind) {
+        compareWithBruteForce<typename decltype(kind)::type>();
+    });
+}
+
+TEST_F(CoveredLengthTests, LongIntervalsOverManySmallOnes)
+{
+    using interval_type = lib_interval_tree::interval<int, lib_interval_tree::right_open>;
+    tree_type<interval_type> tree;
+    std::vector<interval_type> intervals;
+    for (int i = 0; i < 300; ++i)
+        intervals.push_back({i * 3, i * 3 + 2});
+    intervals.push_back({100, 400});
+    intervals.push_back({-50, 10});
+    intervals.push_back({850, 1000});
+
+    tree.assign_unsorted(intervals.begin(), intervals.end());
+    const auto copy = tree;
+    for (int low = -60; low < 1000; low += 45)
+    {
+        const interval_type window{low, low + 120};
+        EXPECT_EQ(copy.covered_length(window), bruteForce(intervals, window));
+    }
+}
+
+TEST_F(CoveredLengthTests, FloatingPointIntervals)
+{
+    tree_type<lib_interval_tree::interval<double>> tree;
+    tree.insert({0.0, 1.5});
+    tree.insert({1.0, 2.0});
+    tree.insert({3.0, 3.5});
+    tree.insert({3.25, 3.25});
+
+    EXPECT_DOUBLE_EQ(tree.covered_length(), 2.5);
+    EXPECT_DOUBLE_EQ(tree.covered_length({0.5, 3.25}), 1.75);
+    EXPECT_DOUBLE_EQ(tree.covered_length({2.0, 3.0}), 0.0);
+}
@@ -4,6 +4,25 @@
 #include <random>
 #include <cmath>
 
+struct FindVisitCountingHook : public lib_interval_tree::hooks::regular
+{
+    struct hook_state
+    {
+        mutable long long visits{0};
+    };
+
+    template <typename tree_type, typename compare_function_type>
+    static inline void on_find(
+        tree_type const& tree,
+        typename tree_type::node_type*,
+        typename tree_type::interval_type const&,
+        compare_function_type
+    ) noexcept
+    {
+        ++tree.visits;
+    }
+};
+
 class FindTests : public ::testing::Test
 {
   public:
@@ -199,4 +218,55 @@ TEST_F(FindTests, FuzzyFindAllInTree)
 
     EXPECT_EQ(findCount, 3);
     ASSERT_TRUE(findIsConsistent);
-}
\ No newline at end of file
+}
+
+TEST_F(FindTests, FindScansOnlyEqualLows)
+{
+    for (int i = 0; i < 1000; ++i)
+        tree.insert({5, 1005 - i});
+    for (int i = 0; i < 1000; ++i)
+        tree.insert({distLarge(gen) % 1000 + 10, 60000});
+
+    auto iter = tree.find({5, 500});
+    ASSERT_NE(iter, std::end(tree));
+    EXPECT_EQ(iter->high(), 500);
+    EXPECT_EQ(tree.find({5, 2000}), std::end(tree));
+    EXPECT_EQ(tree.find({4, 500}), std::end(tree));
+
+    int findCount = 0;
+    tree.find_all({5, 6}, [&findCount](decltype(tree)::iterator iter) {
+        ++findCount;
+        EXPECT_EQ(iter->high(), 6);
+        return true;
+    });
+    EXPECT_EQ(findCount, 1);
+}
+
+TEST_F(FindTests, FindAfterErasesAndRotations)
+{
+    std::vector<decltype(tree)::interval_type> intervals;
+    for (int i = 0; i < 2000; ++i)
+    {
+        const auto low = distLarge(gen) % 50;
+        intervals.push_back(lib_interval_tree::make_safe_interval(low, low + i % 7));
+        tree.insert(intervals.back());
+    }
+    for (std::size_t i = 0; i < intervals.size(); i += 2)
+        tree.erase(tree.find(intervals[i]));
+
+    EXPECT_EQ(tree.size(), 1000);
+    for (std::size_t i = 1; i < intervals.size(); i += 2)
+        ASSERT_NE(tree.find(intervals[i]), std::end(tree));
+    testMaxProperty(tree);
+}
+
+TEST_F(FindTests, FindVisitsLogarithmicNodes)
+{
+    lib_interval_tree::interval_tree<lib_interval_tree::interval<int>, FindVisitCountingHook> countingTree;
+    for (int i = 0; i < 100'000; ++i)
+        countingTree.insert({i, i + 100'000});
+
+    for (int i = 0; i < 100; ++i)
+        ASSERT_NE(countingTree.find({i * 997, i * 997 + 100'000}), std::end(countingTree));
+    EXPECT_LT(countingTree.visits, 100 * 40);
+}
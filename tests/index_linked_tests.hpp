@@ -0,0 +1,160 @@
+#pragma once
+
+#include "test_utility.hpp"
+#include "allocator_tests.hpp"
+
+#include <random>
+#include <vector>
+
+class IndexLinkedTests : public ::testing::Test
+{
+  public:
+    using interval_type = lib_interval_tree::interval<int>;
+    using tree_type = lib_interval_tree::index_linked_interval_tree_t<int>;
+    using pointer_tree_type = lib_interval_tree::interval_tree_t<int>;
+
+  protected:
+    std::default_random_engine gen;
+    std::uniform_int_distribution<int> distLarge{-50000, 50000};
+};
+
+TEST_F(IndexLinkedTests, NodesAreSmallerThanPointerLinkedNodes)
+{
+    EXPECT_LT(sizeof(tree_type::node_type), sizeof(pointer_tree_type::node_type));
+}
+
+TEST_F(IndexLinkedTests, BehavesLikePointerLinkedTree)
+{
+    tree_type tree;
+    pointer_tree_type reference;
+    for (int i = 0; i < 2000; ++i)
+    {
+        const auto ival = lib_interval_tree::make_safe_interval(distLarge(gen), distLarge(gen));
+        tree.insert(ival);
+        reference.insert(ival);
+    }
+    testMaxProperty(tree);
+    testRedBlackPropertyViolation(tree);
+
+    auto eraseOverlapping = [](auto& anyTree, interval_type const& ival) {
+        auto iter = anyTree.overlap_find(ival);
+        anyTree.erase(iter == anyTree.end() ? anyTree.begin() : iter);
+    };
+    for (int i = 0; i < 700; ++i)
+    {
+        const auto ival = lib_interval_tree::make_safe_interval(distLarge(gen), distLarge(gen));
+        eraseOverlapping(tree, ival);
+        eraseOverlapping(reference, ival);
+    }
+    for (int i = 0; i < 500; ++i)
+    {
+        const auto ival = lib_interval_tree::make_safe_interval(distLarge(gen), distLarge(gen));
+        tree.insert(ival);
+        reference.insert(ival);
+    }
+    testMaxProperty(tree);
+
+    ASSERT_EQ(tree.size(), reference.size());
+    auto ref = reference.begin();
+    for (auto const& ival : tree)
+    {
+        EXPECT_EQ(ival, *ref);
+        ++ref;
+    }
+
+    std::vector<interval_type> found;
+    std::vector<interval_type> expected;
+    tree.overlap_find_all({-1000, 1000}, [&found](tree_type::iterator iter) {
+        found.push_back(*iter);
+        return true;
+    });
+    reference.overlap_find_all({-1000, 1000}, [&expected](pointer_tree_type::iterator iter) {
+        expected.push_back(*iter);
+        return true;
+    });
+    EXPECT_EQ(found, expected);
+}
+
+TEST_F(IndexLinkedTests, ReserveKeepsIteratorsValidWhileInserting)
+{
+    tree_type tree;
+    tree.reserve(100);
+    auto first = tree.insert({5, 10});
+    for (int i = 0; i < 99; ++i)
+        tree.insert({i, i + 1});
+
+    EXPECT_EQ(first->low(), 5);
+    EXPECT_EQ(first->high(), 10);
+}
+
+TEST_F(IndexLinkedTests, CopyIsIndependent)
+{
+    tree_type tree;
+    for (int i = 0; i < 100; ++i)
+        tree.insert({i, i + 10});
+
+    auto copy = tree;
+    tree.clear();
+    tree.insert({1000, 2000});
+
+    EXPECT_EQ(copy.size(), 100);
+    testMaxProperty(copy);
+    testRedBlackPropertyViolation(copy);
+    int i = 0;
+    for (auto const& ival : copy)
+    {
+        EXPECT_EQ(ival.low(), i);
+        ++i;
+    }
+}
+
+TEST_F(IndexLinkedTests, FreedSlotsAreReused)
+{
+    AllocationCounter counter;
+    using counted_tree = lib_interval_tree::index_linked_interval_tree_t<
+        int,
+        lib_interval_tree::closed,
+        lib_interval_tree::hooks::regular,
+        CountingAllocator<interval_type>>;
+
+    counted_tree tree{CountingAllocator<interval_type>{&counter}};
+    tree.reserve(64);
+    for (int i = 0; i < 64; ++i)
+        tree.insert({i, i + 1});
+    for (int i = 0; i < 32; ++i)
+        tree.erase(tree.begin());
+    for (int i = 0; i < 32; ++i)
+        tree.insert({i, i + 2});
+    tree.clear();
+    for (int i = 0; i < 64; ++i)
+        tree.insert({i, i + 3});
+
+    EXPECT_EQ(counter.allocations, 1);
+    EXPECT_EQ(tree.size(), 64);
+    testMaxProperty(tree);
+}
+
+TEST_F(IndexLinkedTests, MoveTakesNodeBlock)
+{
+    AllocationCounter counter;
+    using counted_tree = lib_interval_tree::index_linked_interval_tree_t<
+        int,
+        lib_interval_tree::closed,
+        lib_interval_tree::hooks::regular,
+        CountingAllocator<interval_type>>;
+
+    counted_tree tree{CountingAllocator<interval_type>{&counter}};
+    for (int i = 0; i < 100; ++i)
+        tree.insert({i, i + 1});
+    const auto allocations = counter.allocations;
+
+    counted_tree other{std::move(tree)};
+    EXPECT_EQ(counter.allocations, allocations);
+    EXPECT_EQ(other.size(), 100);
+    EXPECT_TRUE(tree.empty());
+    testMaxProperty(other);
+
+    tree = std::move(other);
+    EXPECT_EQ(tree.size(), 100);
+    EXPECT_EQ(tree.begin()->low(), 0);
+}
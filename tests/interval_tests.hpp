@@ -155,7 +155,7 @@ TEST_F(OverlapTests, ShallOverlapItself2)
     EXPECT_TRUE(base4.overlaps({-5, 0}));
 
     auto base5 = i<closed_adjacent>(-5, 0);
-    EXPECT_TRUE(base4.overlaps({-5, 0}));
+    EXPECT_TRUE(base5.overlaps({-5, 0}));
 }
 
 TEST_F(OverlapTests, RightOverlapTests)
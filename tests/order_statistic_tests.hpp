@@ -0,0 +1,97 @@
+#pragma once
+
+#include <random>
+#include <vector>
+
+class OrderStatisticTests : public ::testing::Test
+{
+  public:
+    using tree_type = lib_interval_tree::ranked_interval_tree_t<int>;
+
+  protected:
+    void fill(tree_type& tree, int count)
+    {
+        for (int i = 0; i < count; ++i)
+        {
+            const int low = distValue(gen);
+            tree.insert({low, low + 10});
+            if (i % 3 == 0)
+                tree.erase(tree.nth(static_cast<long long>(gen() % static_cast<unsigned>(tree.size()))));
+        }
+    }
+
+    std::default_random_engine gen;
+    std::uniform_int_distribution<int> distValue{0, 1000};
+};
+
+TEST_F(OrderStatisticTests, NthAndRankMatchIterationOrder)
+{
+    tree_type tree;
+    fill(tree, 3000);
+
+    long long index = 0;
+    for (auto iter = tree.begin(); iter != tree.end(); ++iter, ++index)
+    {
+        EXPECT_EQ(tree.nth(index), iter);
+        EXPECT_EQ(tree.rank(iter), index);
+    }
+    EXPECT_EQ(index, tree.size());
+    EXPECT_EQ(tree.rank(tree.end()), tree.size());
+    EXPECT_EQ(tree.nth(tree.size()), tree.end());
+    EXPECT_EQ(tree.nth(-1), tree.end());
+}
+
+TEST_F(OrderStatisticTests, IndexOfLowMatchesBruteForce)
+{
+    tree_type tree;
+    fill(tree, 2000);
+
+    for (int value = -1; value <= 1001; value += 7)
+    {
+        long long expected = 0;
+        for (auto const& ival : tree)
+            expected += ival.low() < value;
+        EXPECT_EQ(tree.index_of_low(value), expected);
+    }
+}
+
+TEST_F(OrderStatisticTests, AdvanceJumpsLikeRepeatedIncrements)
+{
+    tree_type tree;
+    fill(tree, 1000);
+    std::vector<tree_type::iterator> order;
+    for (auto iter = tree.begin(); iter != tree.end(); ++iter)
+        order.push_back(iter);
+
+    const auto size = static_cast<long long>(order.size());
+    for (long long from = 0; from < size; from += 37)
+    {
+        for (long long count : {0LL, 1LL, 50LL, -1LL, -50LL, size})
+        {
+            const auto to = from + count;
+            const auto expected = to < 0 || to >= size ? tree.end() : order[static_cast<std::size_t>(to)];
+            EXPECT_EQ(tree.advance(order[static_cast<std::size_t>(from)], count), expected);
+        }
+    }
+    EXPECT_EQ(tree.advance(tree.end(), -1), order.back());
+
+    tree_type const& constTree = tree;
+    EXPECT_EQ(constTree.advance(constTree.begin(), 2)->low(), order[2]->low());
+}
+
+TEST_F(OrderStatisticTests, SizesSurviveBulkConstructionAndCopies)
+{
+    std::vector<lib_interval_tree::interval<int>> intervals;
+    for (int i = 0; i < 500; ++i)
+        intervals.push_back({i * 2, i * 2 + 1});
+
+    tree_type tree;
+    tree.assign(intervals.begin(), intervals.end());
+    tree.insert_bulk(intervals.begin(), intervals.begin() + 300);
+    const auto copy = tree;
+
+    EXPECT_EQ(copy.nth(0)->low(), 0);
+    EXPECT_EQ(copy.nth(1)->low(), 0);
+    EXPECT_EQ(copy.index_of_low(100), 100);
+    EXPECT_EQ(copy.nth(copy.size() - 1)->low(), 998);
+}
@@ -0,0 +1,137 @@
+#pragma once
+
+#include <interval-tree/interval_tree_parallel.hpp>
+
+#include "test_utility.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <random>
+#include <tuple>
+#include <vector>
+
+class OverlapJoinTests : public BruteForceTests
+{
+  protected:
+    template <typename TreeT>
+    static overlap_pair_list join(TreeT const& lhs, TreeT const& rhs, bool exclusive)
+    {
+        overlap_pair_list result;
+        lib_interval_tree::overlap_join(
+            lhs,
+            rhs,
+            [&result](auto a, auto b) {
+                result.emplace_back(a->low(), a->high(), b->low(), b->high());
+                return true;
+            },
+            exclusive
+        );
+        std::sort(result.begin(), result.end());
+        return result;
+    }
+
+    template <typename TreeT>
+    static overlap_pair_list parallelJoin(TreeT const& lhs, TreeT const& rhs, bool exclusive, unsigned threads)
+    {
+        overlap_pair_list result;
+        std::mutex mutex;
+        lib_interval_tree::parallel_overlap_join(
+            lhs,
+            rhs,
+            [&result, &mutex](auto a, auto b) {
+                std::lock_guard<std::mutex> lock{mutex};
+                result.emplace_back(a->low(), a->high(), b->low(), b->high());
+                return true;
+            },
+            threads,
+            exclusive
+        );
+        std::sort(result.begin(), result.end());
+        return result;
+    }
+
+    template <typename IntervalT, typename MakeIntervalT>
+    void compareWithBruteForce(MakeIntervalT const& makeInterval, int lhsCount, int rhsCount)
+    {
+        lib_interval_tree::interval_tree<IntervalT> lhs;
+        lib_interval_tree::interval_tree<IntervalT> rhs;
+        for (int i = 0; i < lhsCount; ++i)
+            lhs.insert(makeInterval(distValue(gen), distLength(gen)));
+        for (int i = 0; i < rhsCount; ++i)
+            rhs.insert(makeInterval(distValue(gen), distLength(gen)));
+
+        for (bool exclusive : {false, true})
+        {
+            const auto expected = bruteForceOverlapPairs(lhs, rhs, exclusive);
+            EXPECT_EQ(join(lhs, rhs, exclusive), expected);
+            EXPECT_EQ(parallelJoin(lhs, rhs, exclusive, 4), expected);
+        }
+    }
+};
+
+TEST_F(OverlapJoinTests, EmptyTreesGiveNoPairs)
+{
+    lib_interval_tree::interval_tree_t<int> lhs;
+    lib_interval_tree::interval_tree_t<int> rhs;
+    rhs.insert({0, 10});
+    EXPECT_TRUE(join(lhs, rhs, false).empty());
+    EXPECT_TRUE(join(rhs, lhs, false).empty());
+    EXPECT_TRUE(parallelJoin(lhs, rhs, false, 4).empty());
+}
+
+TEST_F(OverlapJoinTests, AllKindsMatchBruteForce)
+{
+    forEachStaticKind([this](auto kind) {
+        using interval_type = typename decltype(kind)::type;
+        compareWithBruteForce<interval_type>(intervalOfLength<interval_type>, 1000, 700);
+        compareWithBruteForce<interval_type>(intervalOfLength<interval_type>, 700, 1000);
+    });
+}
+
+TEST_F(OverlapJoinTests, DynamicBordersMatchBruteForce)
+{
+    using namespace lib_interval_tree;
+    std::uniform_int_distribution<int> distBorder{0, 2};
+    compareWithBruteForce<interval<int, dynamic>>(
+        [&](int low, int length) {
+            return interval<int, dynamic>{
+                low,
+                low + length + 2,
+                static_cast<interval_border>(distBorder(gen)),
+                static_cast<interval_border>(distBorder(gen))
+            };
+        },
+        800,
+        800
+    );
+}
+
+TEST_F(OverlapJoinTests, JoinCanBeStopped)
+{
+    lib_interval_tree::interval_tree_t<int> lhs;
+    lib_interval_tree::interval_tree_t<int> rhs;
+    for (int i = 0; i < 100; ++i)
+    {
+        lhs.insert({i, i + 5});
+        rhs.insert({i, i + 5});
+    }
+
+    int pairs = 0;
+    lhs.overlap_join(rhs, [&pairs](auto, auto) {
+        return ++pairs < 10;
+    });
+    EXPECT_EQ(pairs, 10);
+
+    std::atomic<int> parallelPairs{0};
+    lib_interval_tree::parallel_overlap_join(
+        lhs,
+        rhs,
+        [&parallelPairs](auto, auto) {
+            return ++parallelPairs < 10;
+        },
+        4
+    );
+    EXPECT_GE(parallelPairs.load(), 10);
+    EXPECT_LT(parallelPairs.load(), 100);
+}
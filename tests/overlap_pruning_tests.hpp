@@ -0,0 +1,141 @@
+#pragma once
+
+#include "test_utility.hpp"
+
+#include <algorithm>
+#include <random>
+#include <utility>
+#include <vector>
+
+struct VisitCountingHook : public lib_interval_tree::hooks::regular
+{
+    struct hook_state
+    {
+        mutable long long visits{0};
+    };
+
+    template <typename tree_type>
+    static inline void on_overlap_find_all(
+        tree_type const& tree,
+        typename tree_type::node_type*,
+        typename tree_type::interval_type const&
+    ) noexcept
+    {
+        ++tree.visits;
+    }
+};
+
+class OverlapPruningTests : public BruteForceTests
+{
+  protected:
+    OverlapPruningTests()
+    {
+        distValue = std::uniform_int_distribution<int>{0, 10000};
+        distLength = std::uniform_int_distribution<int>{0, 20};
+    }
+
+    template <typename IntervalT>
+    static std::vector<std::pair<int, int>> sorted(std::vector<IntervalT> const& intervals)
+    {
+        std::vector<std::pair<int, int>> result;
+        for (auto const& ival : intervals)
+            result.emplace_back(ival.low(), ival.high());
+        std::sort(result.begin(), result.end());
+        return result;
+    }
+
+    /**
+     *  Compares the tree and the static index against testing every interval.
+     */
+    template <typename IntervalT, typename MakeIntervalT>
+    void compareWithBruteForce(MakeIntervalT const& makeInterval)
+    {
+        std::vector<IntervalT> intervals;
+        for (int i = 0; i < 3000; ++i)
+            intervals.push_back(makeInterval(distValue(gen), distLength(gen)));
+
+        lib_interval_tree::interval_tree<IntervalT> tree;
+        for (auto const& ival : intervals)
+            tree.insert(ival);
+        const auto index = tree.freeze();
+
+        for (int i = 0; i < 300; ++i)
+        {
+            const auto query = makeInterval(distValue(gen), distLength(gen));
+            for (bool exclusive : {false, true})
+            {
+                const auto expected = bruteForceOverlaps(intervals, query, exclusive);
+
+                std::vector<IntervalT> fromTree;
+                tree.overlap_find_all(
+                    query,
+                    [&fromTree](auto iter) {
+                        fromTree.push_back(*iter);
+                        return true;
+                    },
+                    exclusive
+                );
+                std::vector<IntervalT> fromIndex;
+                index.overlap_find_all(
+                    query,
+                    [&fromIndex](auto iter) {
+                        fromIndex.push_back(*iter);
+                        return true;
+                    },
+                    exclusive
+                );
+
+                EXPECT_EQ(sorted(fromTree), expected);
+                EXPECT_EQ(sorted(fromIndex), expected);
+
+                const auto first = tree.overlap_find(query, exclusive);
+                EXPECT_EQ(first == tree.end(), expected.empty());
+            }
+        }
+    }
+};
+
+TEST_F(OverlapPruningTests, StaticKindsMatchBruteForce)
+{
+    forEachStaticKind([this](auto kind) {
+        using interval_type = typename decltype(kind)::type;
+        compareWithBruteForce<interval_type>(intervalOfLength<interval_type>);
+    });
+}
+
+TEST_F(OverlapPruningTests, AdjacentIntervalsAreFoundInAllSubtrees)
+{
+    using namespace lib_interval_tree;
+    compareWithBruteForce<interval<int, closed_adjacent>>([](int low, int length) {
+        return interval<int, closed_adjacent>{low, low + length};
+    });
+}
+
+TEST_F(OverlapPruningTests, DynamicBordersMatchBruteForce)
+{
+    using namespace lib_interval_tree;
+    std::uniform_int_distribution<int> distBorder{0, 2};
+    const auto border = [&]() {
+        return static_cast<interval_border>(distBorder(gen));
+    };
+    compareWithBruteForce<interval<int, dynamic>>([&](int low, int length) {
+        return interval<int, dynamic>{low, low + length + 2, border(), border()};
+    });
+}
+
+TEST_F(OverlapPruningTests, NarrowQueriesVisitFewNodes)
+{
+    lib_interval_tree::interval_tree<lib_interval_tree::interval<int>, VisitCountingHook> tree;
+    for (int i = 0; i < 100000; ++i)
+        tree.insert({i * 10, i * 10 + 5});
+
+    int found = 0;
+    tree.overlap_find_all({500000, 500020}, [&found](auto) {
+        ++found;
+        return true;
+    });
+
+    EXPECT_EQ(found, 3);
+    // About three root to leaf paths, far from the ~50000 nodes right of the query, whose max reaches it.
+    EXPECT_LT(tree.visits, 200);
+}
@@ -0,0 +1,120 @@
+#pragma once
+
+#include "test_utility.hpp"
+
+#include <algorithm>
+#include <random>
+#include <tuple>
+#include <vector>
+
+class OverlappingPairTests : public BruteForceTests
+{
+  protected:
+    /**
+     *  Every pair of intervals within tree that overlap, each pair once in the order of iteration.
+     */
+    template <typename TreeT>
+    static overlap_pair_list bruteForce(TreeT const& tree, bool exclusive)
+    {
+        overlap_pair_list result;
+        for (auto a = tree.begin(); a != tree.end(); ++a)
+        {
+            auto b = a;
+            for (++b; b != tree.end(); ++b)
+            {
+                if (exclusive ? a->overlaps_exclusive(*b) : a->overlaps(*b))
+                    result.emplace_back(a->low(), a->high(), b->low(), b->high());
+            }
+        }
+        std::sort(result.begin(), result.end());
+        return result;
+    }
+
+    template <typename TreeT>
+    static overlap_pair_list pairs(TreeT const& tree, bool exclusive)
+    {
+        overlap_pair_list result;
+        tree.for_each_overlapping_pair(
+            [&result](auto a, auto b) {
+                result.emplace_back(a->low(), a->high(), b->low(), b->high());
+                return true;
+            },
+            exclusive
+        );
+        std::sort(result.begin(), result.end());
+        return result;
+    }
+
+    template <typename IntervalT, typename MakeIntervalT>
+    void compareWithBruteForce(MakeIntervalT const& makeInterval, int count)
+    {
+        lib_interval_tree::interval_tree<IntervalT> tree;
+        for (int i = 0; i < count; ++i)
+            tree.insert(makeInterval(distValue(gen), distLength(gen)));
+
+        for (bool exclusive : {false, true})
+            EXPECT_EQ(pairs(tree, exclusive), bruteForce(tree, exclusive));
+    }
+};
+
+TEST_F(OverlappingPairTests, SmallTreesGiveNoPairs)
+{
+    lib_interval_tree::interval_tree_t<int> tree;
+    EXPECT_TRUE(pairs(tree, false).empty());
+    tree.insert({0, 10});
+    EXPECT_TRUE(pairs(tree, false).empty());
+}
+
+TEST_F(OverlappingPairTests, EveryPairIsReportedOnce)
+{
+    lib_interval_tree::interval_tree_t<int> tree;
+    tree.insert({0, 10});
+    tree.insert({0, 10});
+    tree.insert({5, 6});
+    tree.insert({10, 20});
+    tree.insert({21, 30});
+
+    EXPECT_EQ(
+        pairs(tree, false),
+        (overlap_pair_list{{0, 10, 0, 10}, {0, 10, 5, 6}, {0, 10, 5, 6}, {0, 10, 10, 20}, {0, 10, 10, 20}})
+    );
+    EXPECT_EQ(pairs(tree, true), (overlap_pair_list{{0, 10, 0, 10}, {0, 10, 5, 6}, {0, 10, 5, 6}}));
+}
+
+TEST_F(OverlappingPairTests, AllKindsMatchBruteForce)
+{
+    forEachStaticKind([this](auto kind) {
+        using interval_type = typename decltype(kind)::type;
+        compareWithBruteForce<interval_type>(intervalOfLength<interval_type>, 1000);
+    });
+}
+
+TEST_F(OverlappingPairTests, DynamicBordersMatchBruteForce)
+{
+    using namespace lib_interval_tree;
+    std::uniform_int_distribution<int> distBorder{0, 2};
+    compareWithBruteForce<interval<int, dynamic>>(
+        [&](int low, int length) {
+            return interval<int, dynamic>{
+                low,
+                low + length + 2,
+                static_cast<interval_border>(distBorder(gen)),
+                static_cast<interval_border>(distBorder(gen))
+            };
+        },
+        1000
+    );
+}
+
+TEST_F(OverlappingPairTests, EnumerationCanBeStopped)
+{
+    lib_interval_tree::interval_tree_t<int> tree;
+    for (int i = 0; i < 100; ++i)
+        tree.insert({i, i + 5});
+
+    int found = 0;
+    tree.for_each_overlapping_pair([&found](auto, auto) {
+        return ++found < 10;
+    });
+    EXPECT_EQ(found, 10);
+}
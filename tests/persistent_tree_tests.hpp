@@ -0,0 +1,303 @@
+#pragma once
+
+#include <interval-tree/persistent_interval_tree.hpp>
+
+#include "test_utility.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <random>
+#include <thread>
+#include <vector>
+
+class PersistentTreeTests : public ::testing::Test
+{
+  public:
+    using interval_type = lib_interval_tree::interval<int>;
+    using tree_type = lib_interval_tree::persistent_interval_tree<interval_type>;
+
+  protected:
+    template <typename SnapshotT>
+    static std::vector<interval_type>
+    overlaps(SnapshotT const& snapshot, interval_type const& ival, bool exclusive = false)
+    {
+        std::vector<interval_type> result;
+        snapshot.overlap_find_all(
+            ival,
+            [&result](interval_type const& found) {
+                result.push_back(found);
+                return true;
+            },
+            exclusive
+        );
+        return result;
+    }
+
+    template <typename SnapshotT>
+    static std::vector<interval_type> contents(SnapshotT const& snapshot)
+    {
+        std::vector<interval_type> result;
+        snapshot.for_each([&result](interval_type const& ival) {
+            result.push_back(ival);
+            return true;
+        });
+        return result;
+    }
+
+    static void sortByLowThenHigh(std::vector<interval_type>& intervals)
+    {
+        std::sort(intervals.begin(), intervals.end(), [](interval_type const& lhs, interval_type const& rhs) {
+            return lhs.low() < rhs.low() || (lhs.low() == rhs.low() && lhs.high() < rhs.high());
+        });
+    }
+
+    std::default_random_engine gen;
+    std::uniform_int_distribution<int> distValue{0, 2000};
+    std::uniform_int_distribution<int> distLength{0, 30};
+};
+
+TEST_F(PersistentTreeTests, EmptyTreeHasEmptySnapshots)
+{
+    tree_type tree;
+    auto snapshot = tree.get_snapshot();
+    EXPECT_TRUE(snapshot.empty());
+    EXPECT_EQ(snapshot.size(), 0);
+    EXPECT_TRUE(overlaps(snapshot, {0, 100}).empty());
+}
+
+TEST_F(PersistentTreeTests, ChangesAreVisibleAfterCommit)
+{
+    tree_type tree;
+    tree.insert({0, 10});
+    tree.insert({5, 15});
+    EXPECT_EQ(tree.size(), 2);
+    EXPECT_TRUE(tree.get_snapshot().empty());
+
+    tree.commit();
+    auto snapshot = tree.get_snapshot();
+    EXPECT_EQ(snapshot.size(), 2);
+    EXPECT_EQ(overlaps(snapshot, {12, 20}), (std::vector<interval_type>{{5, 15}}));
+}
+
+TEST_F(PersistentTreeTests, SnapshotIsUnaffectedByLaterCommits)
+{
+    tree_type tree;
+    for (int i = 0; i < 100; ++i)
+        tree.insert({i * 10, i * 10 + 5});
+    tree.commit();
+    auto before = tree.get_snapshot();
+
+    for (int i = 0; i < 100; i += 2)
+        EXPECT_TRUE(tree.erase({i * 10, i * 10 + 5}));
+    tree.insert({3, 4});
+    tree.commit();
+    auto after = tree.get_snapshot();
+
+    EXPECT_EQ(before.size(), 100);
+    EXPECT_EQ(overlaps(before, {0, 25}), (std::vector<interval_type>{{0, 5}, {10, 15}, {20, 25}}));
+    EXPECT_EQ(after.size(), 51);
+    EXPECT_EQ(overlaps(after, {0, 25}), (std::vector<interval_type>{{3, 4}, {10, 15}}));
+}
+
+TEST_F(PersistentTreeTests, MatchesIntervalTreeAfterRandomChanges)
+{
+    tree_type tree;
+    lib_interval_tree::interval_tree<interval_type> reference;
+    std::vector<interval_type> inserted;
+    for (int round = 0; round < 20; ++round)
+    {
+        for (int i = 0; i < 200; ++i)
+        {
+            const auto low = distValue(gen);
+            const interval_type ival{low, low + distLength(gen)};
+            tree.insert(ival);
+            reference.insert(ival);
+            inserted.push_back(ival);
+        }
+        for (int i = 0; i < 100; ++i)
+        {
+            const auto index = static_cast<std::size_t>(distValue(gen)) % inserted.size();
+            const auto ival = inserted[index];
+            inserted.erase(inserted.begin() + static_cast<std::ptrdiff_t>(index));
+            EXPECT_TRUE(tree.erase(ival));
+            reference.erase(reference.find(ival));
+        }
+        EXPECT_FALSE(tree.erase({-10, -5}));
+        tree.commit();
+
+        auto snapshot = tree.get_snapshot();
+        ASSERT_EQ(snapshot.size(), reference.size());
+        for (int query = 0; query < 20; ++query)
+        {
+            const auto low = distValue(gen);
+            const interval_type ival{low, low + distLength(gen)};
+            for (bool exclusive : {false, true})
+            {
+                auto found = overlaps(snapshot, ival, exclusive);
+                std::vector<interval_type> expected;
+                reference.overlap_find_all(
+                    ival,
+                    [&expected](auto iter) {
+                        expected.push_back(*iter);
+                        return true;
+                    },
+                    exclusive
+                );
+                sortByLowThenHigh(found);
+                sortByLowThenHigh(expected);
+                EXPECT_EQ(found, expected);
+            }
+        }
+    }
+}
+
+TEST_F(PersistentTreeTests, ForEachIsSortedByLow)
+{
+    tree_type tree;
+    for (int i = 0; i < 1000; ++i)
+    {
+        const auto low = distValue(gen);
+        tree.insert({low, low + distLength(gen)});
+    }
+    tree.commit();
+
+    const auto all = contents(tree.get_snapshot());
+    EXPECT_EQ(all.size(), 1000);
+    EXPECT_TRUE(std::is_sorted(all.begin(), all.end(), [](interval_type const& lhs, interval_type const& rhs) {
+        return lhs.low() < rhs.low();
+    }));
+}
+
+TEST_F(PersistentTreeTests, EraseFindsIntervalAmongEqualLows)
+{
+    tree_type tree;
+    for (int i = 0; i < 100; ++i)
+        tree.insert({5, 6 + i});
+    for (int i = 99; i >= 0; i -= 3)
+        EXPECT_TRUE(tree.erase({5, 6 + i}));
+    EXPECT_FALSE(tree.erase({5, 6 + 99}));
+    tree.commit();
+
+    const auto all = contents(tree.get_snapshot());
+    EXPECT_EQ(all.size(), 66);
+    EXPECT_TRUE(std::none_of(all.begin(), all.end(), [](interval_type const& ival) {
+        return (ival.high() - 6) % 3 == 0;
+    }));
+}
+
+TEST_F(PersistentTreeTests, StabFindsContainingIntervals)
+{
+    lib_interval_tree::persistent_interval_tree<lib_interval_tree::interval<int, lib_interval_tree::right_open>> tree;
+    tree.insert({0, 5});
+    tree.insert({5, 10});
+    tree.insert({3, 7});
+    tree.commit();
+
+    std::vector<int> lows;
+    tree.get_snapshot().stab(5, [&lows](auto const& ival) {
+        lows.push_back(ival.low());
+        return true;
+    });
+    EXPECT_EQ(lows, (std::vector<int>{3, 5}));
+}
+
+TEST_F(PersistentTreeTests, RetiredNodesAreFreedOnceNoSnapshotReachesThem)
+{
+    AllocationCounter counter;
+    using counted_tree = lib_interval_tree::persistent_interval_tree<interval_type, CountingAllocator<interval_type>>;
+    {
+        counted_tree tree{CountingAllocator<interval_type>{&counter}};
+        for (int i = 0; i < 100; ++i)
+            tree.insert({i, i + 1});
+        tree.commit();
+        EXPECT_EQ(tree.retired_count(), 0);
+
+        {
+            auto snapshot = tree.get_snapshot();
+            auto copy = snapshot;
+            tree.erase({50, 51});
+            tree.insert({200, 300});
+            tree.commit();
+            EXPECT_GT(tree.retired_count(), 0);
+
+            auto moved = std::move(snapshot);
+            tree.commit();
+            EXPECT_GT(tree.retired_count(), 0);
+            EXPECT_EQ(copy.size(), 100);
+            EXPECT_EQ(moved.size(), 100);
+        }
+
+        tree.reclaim();
+        EXPECT_EQ(tree.retired_count(), 0);
+        EXPECT_EQ(tree.get_snapshot().size(), 100);
+    }
+    EXPECT_EQ(counter.live(), 0);
+}
+
+TEST_F(PersistentTreeTests, ChangesBetweenCommitsCopyEachNodeOnce)
+{
+    tree_type tree;
+    for (int i = 0; i < 1000; ++i)
+        tree.insert({i, i + 1});
+    EXPECT_EQ(tree.retired_count(), 0);
+    tree.commit();
+
+    tree.insert({1000, 1001});
+    const auto afterFirst = tree.retired_count();
+    EXPECT_GT(afterFirst, 0);
+    tree.insert({1000, 1002});
+    EXPECT_LE(tree.retired_count(), afterFirst + 2);
+
+    tree.clear();
+    EXPECT_TRUE(tree.empty());
+    tree.commit();
+    EXPECT_EQ(tree.retired_count(), 0);
+    EXPECT_TRUE(tree.get_snapshot().empty());
+}
+
+TEST_F(PersistentTreeTests, ReadersSeeConsistentVersionsWhileWriterCommits)
+{
+    tree_type tree;
+    std::atomic<bool> done{false};
+    std::atomic<int> inconsistent{0};
+
+    std::vector<std::thread> readers;
+    for (int reader = 0; reader < 3; ++reader)
+    {
+        readers.emplace_back([&] {
+            while (!done.load())
+            {
+                auto snapshot = tree.get_snapshot();
+                // The writer commits whole rounds of {i, i + 1} for i < size.
+                int expected = 0;
+                snapshot.for_each([&](interval_type const& ival) {
+                    if (ival.low() != expected)
+                        ++inconsistent;
+                    ++expected;
+                    return true;
+                });
+                if (static_cast<std::size_t>(expected) != snapshot.size())
+                    ++inconsistent;
+            }
+        });
+    }
+
+    for (int i = 0; i < 2000; ++i)
+    {
+        tree.insert({i, i + 1});
+        if (i % 7 == 0)
+        {
+            tree.erase({i, i + 1});
+            tree.insert({i, i + 1});
+        }
+        tree.commit();
+    }
+    done = true;
+    for (auto& reader : readers)
+        reader.join();
+
+    EXPECT_EQ(inconsistent.load(), 0);
+    EXPECT_EQ(tree.get_snapshot().size(), 2000);
+    tree.reclaim();
+    EXPECT_EQ(tree.retired_count(), 0);
+}
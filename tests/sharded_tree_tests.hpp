@@ -0,0 +1,210 @@
+#pragma once
+
+#include <interval-tree/sharded_interval_tree.hpp>
+
+#include "test_utility.hpp"
+
+#include <algorithm>
+#include <random>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+class ShardedTreeTests : public BruteForceTests
+{
+  protected:
+    template <typename IntervalT>
+    using sharded_tree = lib_interval_tree::sharded_interval_tree<IntervalT>;
+
+    ShardedTreeTests()
+    {
+        distValue = std::uniform_int_distribution<int>{0, 2000};
+        distLength = std::uniform_int_distribution<int>{0, 600};
+    }
+
+    template <typename IntervalT>
+    static std::vector<std::pair<int, int>>
+    overlaps(sharded_tree<IntervalT> const& tree, IntervalT const& ival, bool exclusive = false)
+    {
+        std::vector<std::pair<int, int>> result;
+        tree.overlap_find_all(
+            ival,
+            [&result](IntervalT const& found) {
+                result.emplace_back(found.low(), found.high());
+                return true;
+            },
+            exclusive
+        );
+        std::sort(result.begin(), result.end());
+        return result;
+    }
+
+    template <typename IntervalT, typename MakeIntervalT>
+    void compareWithBruteForce(MakeIntervalT const& makeInterval)
+    {
+        // Long intervals cross several of the 8 shards of width 250.
+        sharded_tree<IntervalT> tree{8, 0, 2000};
+        std::vector<IntervalT> intervals;
+        for (int i = 0; i < 1000; ++i)
+        {
+            intervals.push_back(makeInterval(distValue(gen), distLength(gen)));
+            tree.insert(intervals.back());
+        }
+        for (int i = 0; i < 300; ++i)
+        {
+            EXPECT_TRUE(tree.erase(intervals.back()));
+            intervals.pop_back();
+        }
+        EXPECT_EQ(tree.size(), intervals.size());
+
+        for (int query = 0; query < 200; ++query)
+        {
+            const auto ival = makeInterval(distValue(gen) - 100, distLength(gen));
+            for (bool exclusive : {false, true})
+                EXPECT_EQ(overlaps(tree, ival, exclusive), bruteForceOverlaps(intervals, ival, exclusive));
+        }
+        // On the boundaries of shards.
+        for (int boundary = 0; boundary <= 2000; boundary += 250)
+        {
+            for (bool exclusive : {false, true})
+            {
+                const auto ival = makeInterval(boundary, 0);
+                EXPECT_EQ(overlaps(tree, ival, exclusive), bruteForceOverlaps(intervals, ival, exclusive));
+            }
+        }
+    }
+};
+
+TEST_F(ShardedTreeTests, InvalidConstructionThrows)
+{
+    using tree_type = sharded_tree<lib_interval_tree::interval<int>>;
+    EXPECT_THROW(tree_type(0, 0, 100), std::invalid_argument);
+    EXPECT_THROW(tree_type(4, 100, 0), std::invalid_argument);
+}
+
+TEST_F(ShardedTreeTests, IntervalsAcrossShardsAreReportedOnce)
+{
+    sharded_tree<lib_interval_tree::interval<int>> tree{4, 0, 400};
+    tree.insert({50, 350});
+    tree.insert({150, 160});
+    EXPECT_EQ(tree.shard_sizes(), (std::vector<std::size_t>{1, 2, 1, 1}));
+
+    EXPECT_EQ(overlaps(tree, {0, 400}), (std::vector<std::pair<int, int>>{{50, 350}, {150, 160}}));
+    EXPECT_EQ(overlaps(tree, {300, 310}), (std::vector<std::pair<int, int>>{{50, 350}}));
+
+    EXPECT_TRUE(tree.erase({50, 350}));
+    EXPECT_FALSE(tree.erase({50, 350}));
+    EXPECT_EQ(tree.shard_sizes(), (std::vector<std::size_t>{0, 1, 0, 0}));
+    EXPECT_TRUE(overlaps(tree, {300, 310}).empty());
+}
+
+TEST_F(ShardedTreeTests, AllKindsMatchBruteForce)
+{
+    forEachStaticKind([this](auto kind) {
+        using interval_type = typename decltype(kind)::type;
+        compareWithBruteForce<interval_type>(intervalOfLength<interval_type>);
+    });
+}
+
+TEST_F(ShardedTreeTests, AdjacentIntervalsMeetAcrossBoundaries)
+{
+    using namespace lib_interval_tree;
+    sharded_tree<interval<int, closed_adjacent>> tree{2, 0, 200};
+    tree.insert({90, 99});
+    EXPECT_EQ(overlaps(tree, {100, 110}), (std::vector<std::pair<int, int>>{{90, 99}}));
+}
+
+TEST_F(ShardedTreeTests, StabVisitsOneShard)
+{
+    sharded_tree<lib_interval_tree::interval<int, lib_interval_tree::right_open>> tree{4, 0, 400};
+    tree.insert({0, 100});
+    tree.insert({100, 300});
+    tree.insert({250, 260});
+
+    std::vector<int> lows;
+    tree.stab(100, [&lows](auto const& ival) {
+        lows.push_back(ival.low());
+        return true;
+    });
+    EXPECT_EQ(lows, (std::vector<int>{100}));
+}
+
+TEST_F(ShardedTreeTests, SearchCanBeStopped)
+{
+    sharded_tree<lib_interval_tree::interval<int>> tree{4, 0, 400};
+    for (int i = 0; i < 400; ++i)
+        tree.insert({i, i + 50});
+
+    int found = 0;
+    tree.overlap_find_all({0, 400}, [&found](auto const&) {
+        return ++found < 10;
+    });
+    EXPECT_EQ(found, 10);
+}
+
+TEST_F(ShardedTreeTests, SkewedShardsAreRebalanced)
+{
+    lib_interval_tree::sharded_options options;
+    options.min_rebalance_size = 100;
+    sharded_tree<lib_interval_tree::interval<int>> tree{4, 0, 4000, options};
+    for (int i = 0; i < 1000; ++i)
+        tree.insert({i, i + 1});
+
+    const auto sizes = tree.shard_sizes();
+    EXPECT_LT(*std::max_element(sizes.begin(), sizes.end()), 1000);
+    EXPECT_LT(tree.boundaries().front(), 1000);
+    EXPECT_EQ(tree.size(), 1000);
+    EXPECT_EQ(overlaps(tree, {0, 2000}).size(), 1000);
+    for (int i = 0; i < 1000; ++i)
+        EXPECT_TRUE(tree.erase({i, i + 1}));
+    EXPECT_TRUE(tree.empty());
+}
+
+TEST_F(ShardedTreeTests, ExplicitRebalanceUsesQuantilesOfLows)
+{
+    sharded_tree<lib_interval_tree::interval<int>> tree{4, 0, 1000000};
+    for (int i = 0; i < 400; ++i)
+        tree.insert({i, i + 10});
+    tree.rebalance();
+    EXPECT_EQ(tree.boundaries(), (std::vector<int>{100, 200, 300}));
+    EXPECT_EQ(tree.shard_sizes(), (std::vector<std::size_t>{100, 110, 110, 110}));
+    EXPECT_EQ(overlaps(tree, {95, 105}).size(), 21);
+}
+
+TEST_F(ShardedTreeTests, ConcurrentWritersAndReaders)
+{
+    lib_interval_tree::sharded_options options;
+    options.min_rebalance_size = 500;
+    sharded_tree<lib_interval_tree::interval<int>> tree{4, 0, 4000, options};
+
+    std::vector<std::thread> threads;
+    for (int writer = 0; writer < 4; ++writer)
+    {
+        threads.emplace_back([&tree, writer] {
+            for (int i = 0; i < 500; ++i)
+            {
+                const int low = writer * 1000 + i;
+                tree.insert({low, low + 600});
+                if (i % 3 == 0)
+                    tree.erase({low, low + 600});
+            }
+        });
+    }
+    threads.emplace_back([&tree] {
+        for (int i = 0; i < 200; ++i)
+        {
+            std::vector<std::pair<int, int>> found;
+            tree.overlap_find_all({0, 5000}, [&found](auto const& ival) {
+                found.emplace_back(ival.low(), ival.high());
+                return true;
+            });
+            std::sort(found.begin(), found.end());
+            EXPECT_TRUE(std::adjacent_find(found.begin(), found.end()) == found.end());
+        }
+    });
+    for (auto& thread : threads)
+        thread.join();
+
+    EXPECT_EQ(tree.size(), 4 * 333);
+    EXPECT_EQ(overlaps(tree, {0, 5000}).size(), 4 * 333);
+}
@@ -0,0 +1,183 @@
+#pragma once
+
+#include <interval-tree/interval_skip_list.hpp>
+
+#include "test_utility.hpp"
+
+#include <algorithm>
+#include <random>
+#include <thread>
+#include <utility>
+#include <vector>
+
+class SkipListTests : public BruteForceTests
+{
+  protected:
+    template <typename IntervalT>
+    using skip_list = lib_interval_tree::concurrent_interval_skip_list<IntervalT>;
+
+    SkipListTests()
+    {
+        distValue = std::uniform_int_distribution<int>{0, 2000};
+        distLength = std::uniform_int_distribution<int>{0, 100};
+    }
+
+    template <typename IntervalT>
+    static std::vector<std::pair<int, int>>
+    overlaps(skip_list<IntervalT> const& list, IntervalT const& ival, bool exclusive = false)
+    {
+        std::vector<std::pair<int, int>> result;
+        list.overlap_find_all(
+            ival,
+            [&result](IntervalT const& found) {
+                result.emplace_back(found.low(), found.high());
+                return true;
+            },
+            exclusive
+        );
+        return result;
+    }
+
+    template <typename IntervalT, typename MakeIntervalT>
+    void compareWithBruteForce(MakeIntervalT const& makeInterval)
+    {
+        skip_list<IntervalT> list;
+        std::vector<IntervalT> intervals;
+        for (int i = 0; i < 2000; ++i)
+        {
+            intervals.push_back(makeInterval(distValue(gen), distLength(gen)));
+            list.insert(intervals.back());
+        }
+        EXPECT_EQ(list.size(), intervals.size());
+
+        for (int query = 0; query < 300; ++query)
+        {
+            const auto ival = makeInterval(distValue(gen) - 100, distLength(gen));
+            for (bool exclusive : {false, true})
+            {
+                // Reported in ascending order of low, equal lows in any order.
+                auto found = overlaps(list, ival, exclusive);
+                EXPECT_TRUE(std::is_sorted(found.begin(), found.end(), [](auto const& lhs, auto const& rhs) {
+                    return lhs.first < rhs.first;
+                }));
+                std::sort(found.begin(), found.end());
+                EXPECT_EQ(found, bruteForceOverlaps(intervals, ival, exclusive));
+            }
+        }
+    }
+};
+
+TEST_F(SkipListTests, AllKindsMatchBruteForce)
+{
+    forEachStaticKind([this](auto kind) {
+        using interval_type = typename decltype(kind)::type;
+        compareWithBruteForce<interval_type>(intervalOfLength<interval_type>);
+    });
+}
+
+TEST_F(SkipListTests, DuplicatesAreKept)
+{
+    skip_list<lib_interval_tree::interval<int>> list;
+    for (int i = 0; i < 3; ++i)
+        list.insert({5, 10});
+    list.insert({0, 4});
+
+    EXPECT_EQ(list.size(), 4);
+    EXPECT_EQ(overlaps(list, {4, 5}), (std::vector<std::pair<int, int>>{{0, 4}, {5, 10}, {5, 10}, {5, 10}}));
+}
+
+TEST_F(SkipListTests, StabFindsContainingIntervals)
+{
+    skip_list<lib_interval_tree::interval<int, lib_interval_tree::right_open>> list;
+    list.insert({0, 10});
+    list.insert({10, 20});
+    list.insert({5, 6});
+
+    std::vector<std::pair<int, int>> found;
+    list.stab(10, [&found](auto const& ival) {
+        found.emplace_back(ival.low(), ival.high());
+        return true;
+    });
+    EXPECT_EQ(found, (std::vector<std::pair<int, int>>{{10, 20}}));
+}
+
+TEST_F(SkipListTests, ForEachVisitsInOrderAndCanBeStopped)
+{
+    skip_list<lib_interval_tree::interval<int>> list;
+    for (int low : {7, 3, 9, 1, 5})
+        list.insert({low, low + 1});
+
+    std::vector<int> lows;
+    list.for_each([&lows](auto const& ival) {
+        lows.push_back(ival.low());
+        return lows.size() < 4;
+    });
+    EXPECT_EQ(lows, (std::vector<int>{1, 3, 5, 7}));
+
+    int found = 0;
+    list.overlap_find_all({0, 10}, [&found](auto const&) {
+        return ++found < 2;
+    });
+    EXPECT_EQ(found, 2);
+}
+
+TEST_F(SkipListTests, FloatingPointIntervals)
+{
+    lib_interval_tree::concurrent_interval_skip_list<lib_interval_tree::interval<double>> list;
+    list.insert({-1.5, -0.5});
+    list.insert({0.25, 0.75});
+    EXPECT_FALSE(list.empty());
+
+    int found = 0;
+    list.stab(-1.0, [&found](auto const&) {
+        ++found;
+        return true;
+    });
+    EXPECT_EQ(found, 1);
+}
+
+TEST_F(SkipListTests, ConcurrentInsertsAndQueries)
+{
+    skip_list<lib_interval_tree::interval<int>> list;
+
+    std::vector<std::thread> threads;
+    for (int writer = 0; writer < 4; ++writer)
+    {
+        threads.emplace_back([&list, writer] {
+            // Interleaved lows, so writers link next to each other.
+            for (int i = 0; i < 2000; ++i)
+            {
+                const int low = i * 4 + writer;
+                list.insert({low, low + (i % 7) * 10});
+            }
+        });
+    }
+    threads.emplace_back([&list] {
+        for (int i = 0; i < 200; ++i)
+        {
+            int previous = -1;
+            list.overlap_find_all({1000, 1100}, [&previous](auto const& ival) {
+                EXPECT_LE(previous, ival.low());
+                previous = ival.low();
+                return true;
+            });
+        }
+    });
+    for (auto& thread : threads)
+        thread.join();
+
+    EXPECT_EQ(list.size(), 4 * 2000);
+    std::vector<lib_interval_tree::interval<int>> intervals;
+    for (int writer = 0; writer < 4; ++writer)
+    {
+        for (int i = 0; i < 2000; ++i)
+            intervals.push_back({i * 4 + writer, i * 4 + writer + (i % 7) * 10});
+    }
+    for (int query = 0; query < 100; ++query)
+    {
+        const lib_interval_tree::interval<int> ival{query * 80, query * 80 + 15};
+        auto found = overlaps(list, ival);
+        std::sort(found.begin(), found.end());
+        EXPECT_EQ(found, bruteForceOverlaps(intervals, ival, false));
+    }
+}
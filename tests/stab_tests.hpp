@@ -0,0 +1,159 @@
+#pragma once
+
+#include "test_utility.hpp"
+
+#include <random>
+#include <vector>
+
+struct StabCountingHook : public lib_interval_tree::hooks::regular
+{
+    struct hook_state
+    {
+        mutable long long visits{0};
+    };
+
+    template <typename tree_type>
+    static inline void
+    on_stab(tree_type const& tree, typename tree_type::node_type*, typename tree_type::value_type const&) noexcept
+    {
+        ++tree.visits;
+    }
+};
+
+class StabTests : public BruteForceTests
+{
+  protected:
+    StabTests()
+    {
+        distValue = std::uniform_int_distribution<int>{0, 10000};
+        distLength = std::uniform_int_distribution<int>{0, 20};
+    }
+
+    /**
+     *  Compares stab and stab_first against testing within() of every interval.
+     */
+    template <typename IntervalT, typename MakeIntervalT>
+    void compareWithBruteForce(MakeIntervalT const& makeInterval)
+    {
+        std::vector<IntervalT> intervals;
+        for (int i = 0; i < 3000; ++i)
+            intervals.push_back(makeInterval(distValue(gen), distLength(gen)));
+
+        lib_interval_tree::interval_tree<IntervalT> tree;
+        for (auto const& ival : intervals)
+            tree.insert(ival);
+
+        for (int i = 0; i < 300; ++i)
+        {
+            const auto value = distValue(gen);
+            const auto expected = bruteForce(intervals, [value](IntervalT const& ival) {
+                return ival.within(value);
+            });
+
+            long long found = 0;
+            tree.stab(value, [&](auto iter) {
+                EXPECT_TRUE(iter->within(value));
+                ++found;
+                return true;
+            });
+            EXPECT_EQ(found, static_cast<long long>(expected.size()));
+
+            const auto first = tree.stab_first(value);
+            ASSERT_EQ(first == tree.end(), expected.empty());
+            if (first != tree.end())
+            {
+                EXPECT_TRUE(first->within(value));
+            }
+        }
+    }
+};
+
+TEST_F(StabTests, EmptyTreeFindsNothing)
+{
+    lib_interval_tree::interval_tree_t<int> tree;
+    EXPECT_EQ(tree.stab_first(5), tree.end());
+    tree.stab(5, [](auto) {
+        ADD_FAILURE();
+        return true;
+    });
+}
+
+TEST_F(StabTests, UsesWithinOfTheKind)
+{
+    using namespace lib_interval_tree;
+    interval_tree<interval<int, right_open>> tree;
+    tree.insert({0, 5});
+    tree.insert({5, 10});
+
+    std::vector<int> lows;
+    tree.stab(5, [&lows](auto iter) {
+        lows.push_back(iter->low());
+        return true;
+    });
+    ASSERT_EQ(lows.size(), 1);
+    EXPECT_EQ(lows[0], 5);
+    EXPECT_EQ(tree.stab_first(10), tree.end());
+    EXPECT_EQ(tree.stab_first(0)->low(), 0);
+}
+
+TEST_F(StabTests, StabFirstReturnsFirstInOrder)
+{
+    lib_interval_tree::interval_tree_t<int> tree;
+    for (int i = 0; i < 100; ++i)
+        tree.insert({i, 200});
+
+    EXPECT_EQ(tree.stab_first(50)->low(), 0);
+    const auto& constTree = tree;
+    EXPECT_EQ(constTree.stab_first(200)->low(), 0);
+    EXPECT_EQ(constTree.stab_first(201), constTree.end());
+}
+
+TEST_F(StabTests, StabCanExitPreemptively)
+{
+    lib_interval_tree::interval_tree_t<int> tree;
+    for (int i = 0; i < 100; ++i)
+        tree.insert({i, i + 10});
+
+    int findCount = 0;
+    tree.stab(50, [&findCount](auto) {
+        return ++findCount < 3;
+    });
+    EXPECT_EQ(findCount, 3);
+}
+
+TEST_F(StabTests, AllKindsMatchBruteForce)
+{
+    using namespace lib_interval_tree;
+    forEachStaticKind([this](auto kind) {
+        using interval_type = typename decltype(kind)::type;
+        compareWithBruteForce<interval_type>(intervalOfLength<interval_type>);
+    });
+
+    std::uniform_int_distribution<int> distBorder{0, 2};
+    compareWithBruteForce<interval<int, dynamic>>([&](int low, int length) {
+        return interval<int, dynamic>{
+            low,
+            low + length + 2,
+            static_cast<interval_border>(distBorder(gen)),
+            static_cast<interval_border>(distBorder(gen))
+        };
+    });
+}
+
+TEST_F(StabTests, StabVisitsFewNodes)
+{
+    lib_interval_tree::interval_tree<lib_interval_tree::interval<int>, StabCountingHook> tree;
+    for (int i = 0; i < 100000; ++i)
+        tree.insert({i * 10, i * 10 + 5});
+
+    for (int i = 0; i < 100; ++i)
+    {
+        int findCount = 0;
+        tree.stab(i * 9970 + 3, [&findCount](auto) {
+            ++findCount;
+            return true;
+        });
+        EXPECT_EQ(findCount, 1);
+    }
+    EXPECT_LT(tree.visits, 100 * 80);
+}
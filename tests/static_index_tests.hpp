@@ -0,0 +1,208 @@
+#pragma once
+
+#include "test_utility.hpp"
+
+#include <algorithm>
+#include <random>
+#include <utility>
+#include <vector>
+
+class StaticIndexTests : public ::testing::Test
+{
+  public:
+    using interval_type = lib_interval_tree::interval<int>;
+    using tree_type = lib_interval_tree::interval_tree_t<int>;
+    using index_type = lib_interval_tree::static_interval_index<interval_type>;
+
+  protected:
+    template <typename TreeOrIndexT>
+    std::vector<interval_type> overlaps(TreeOrIndexT const& container, interval_type const& ival, bool exclusive)
+    {
+        std::vector<interval_type> result;
+        container.overlap_find_all(
+            ival,
+            [&result](auto iter) {
+                result.push_back(*iter);
+                return true;
+            },
+            exclusive
+        );
+        std::sort(result.begin(), result.end(), [](auto const& lhs, auto const& rhs) {
+            return lhs.low() < rhs.low() || (lhs.low() == rhs.low() && lhs.high() < rhs.high());
+        });
+        return result;
+    }
+
+    std::default_random_engine gen;
+    std::uniform_int_distribution<int> distLarge{-50000, 50000};
+    std::uniform_int_distribution<int> distSmall{0, 500};
+};
+
+TEST_F(StaticIndexTests, EmptyIndexFindsNothing)
+{
+    index_type index;
+    EXPECT_TRUE(index.empty());
+    EXPECT_EQ(index.overlap_find({0, 10}), index.end());
+    EXPECT_EQ(index.find({0, 10}), index.end());
+}
+
+TEST_F(StaticIndexTests, FreezeKeepsIntervalsInOrder)
+{
+    tree_type tree;
+    for (int i = 0; i < 1000; ++i)
+        tree.insert(lib_interval_tree::make_safe_interval(distLarge(gen), distLarge(gen)));
+
+    auto index = tree.freeze();
+    ASSERT_EQ(index.size(), static_cast<std::size_t>(tree.size()));
+    auto indexIter = index.begin();
+    for (auto const& ival : tree)
+    {
+        EXPECT_EQ(ival, *indexIter);
+        ++indexIter;
+    }
+}
+
+TEST_F(StaticIndexTests, OverlapFindAllMatchesTree)
+{
+    for (int size : {1, 2, 3, 7, 16, 17, 100, 1023, 1024, 1025, 5000})
+    {
+        tree_type tree;
+        for (int i = 0; i < size; ++i)
+        {
+            const auto low = distLarge(gen);
+            tree.insert({low, low + distSmall(gen)});
+        }
+        const auto index = tree.freeze();
+
+        for (int i = 0; i < 200; ++i)
+        {
+            const auto low = distLarge(gen);
+            const interval_type query{low, low + distSmall(gen)};
+            EXPECT_EQ(overlaps(index, query, false), overlaps(tree, query, false));
+            EXPECT_EQ(overlaps(index, query, true), overlaps(tree, query, true));
+        }
+    }
+}
+
+TEST_F(StaticIndexTests, OverlapsAreReportedInOrderOfLow)
+{
+    std::vector<interval_type> intervals;
+    for (int i = 0; i < 500; ++i)
+        intervals.push_back(lib_interval_tree::make_safe_interval(distLarge(gen), distLarge(gen)));
+    const index_type index{intervals.begin(), intervals.end()};
+
+    std::vector<int> lows;
+    index.overlap_find_all({-100, 100}, [&lows](index_type::const_iterator iter) {
+        lows.push_back(iter->low());
+        return true;
+    });
+    EXPECT_FALSE(lows.empty());
+    EXPECT_TRUE(std::is_sorted(lows.begin(), lows.end()));
+}
+
+TEST_F(StaticIndexTests, OverlapFindAllStopsWhenAsked)
+{
+    std::vector<interval_type> intervals;
+    for (int i = 0; i < 100; ++i)
+        intervals.push_back({i, i + 10});
+    const index_type index{intervals.begin(), intervals.end()};
+
+    int calls = 0;
+    index.overlap_find_all({0, 100}, [&calls](index_type::const_iterator) {
+        ++calls;
+        return calls < 3;
+    });
+    EXPECT_EQ(calls, 3);
+    EXPECT_EQ(*index.overlap_find({50, 55}), (interval_type{40, 50}));
+}
+
+TEST_F(StaticIndexTests, FindAllFindsExactMatches)
+{
+    std::vector<interval_type> intervals{{5, 10}, {1, 3}, {5, 10}, {5, 12}, {20, 30}, {5, 10}};
+    const index_type index{intervals.begin(), intervals.end()};
+
+    int found = 0;
+    index.find_all({5, 10}, [&found](index_type::const_iterator iter) {
+        EXPECT_EQ(*iter, (interval_type{5, 10}));
+        ++found;
+        return true;
+    });
+    EXPECT_EQ(found, 3);
+    EXPECT_EQ(index.find({5, 11}), index.end());
+    EXPECT_EQ(*index.find({20, 30}), (interval_type{20, 30}));
+}
+
+TEST_F(StaticIndexTests, FindAllWithCompareMatchesTree)
+{
+    tree_type tree;
+    for (int i = 0; i < 2000; ++i)
+    {
+        const auto low = distLarge(gen);
+        tree.insert({low, low + distSmall(gen)});
+    }
+    const auto index = tree.freeze();
+    const auto sameHigh = [](interval_type const& lhs, interval_type const& rhs) {
+        return lhs.high() == rhs.high();
+    };
+
+    auto existing = tree.begin();
+    for (int i = 0; i < 100; ++i, ++existing)
+    {
+        const auto high = i % 2 == 0 ? distLarge(gen) : existing->high();
+        const interval_type query{high, high};
+        int treeCount = 0;
+        int indexCount = 0;
+        tree.find_all(
+            query,
+            [&treeCount](tree_type::iterator) {
+                ++treeCount;
+                return true;
+            },
+            sameHigh
+        );
+        index.find_all(
+            query,
+            [&indexCount](index_type::const_iterator) {
+                ++indexCount;
+                return true;
+            },
+            sameHigh
+        );
+        EXPECT_EQ(indexCount, treeCount);
+    }
+}
+
+TEST_F(StaticIndexTests, LongIntervalsAtTheEndAreNotPruned)
+{
+    // Subtrees that hang off the end of the array take the max of the rightmost node of each level,
+    // a long interval close to the end has to reach every level above it.
+    for (int size = 1; size <= 300; ++size)
+    {
+        for (int longIndex = std::max(0, size - 8); longIndex < size; ++longIndex)
+        {
+            std::vector<interval_type> intervals;
+            for (int i = 0; i < size; ++i)
+                intervals.push_back({i * 10, i * 10 + (i == longIndex ? 100000 : 5)});
+            const index_type index{intervals.begin(), intervals.end()};
+
+            for (int low = -10; low < size * 10 + 100; low += 13)
+            {
+                const interval_type query{low, low + 3};
+                for (bool exclusive : {false, true})
+                {
+                    std::vector<std::pair<int, int>> found;
+                    index.overlap_find_all(
+                        query,
+                        [&found](index_type::const_iterator iter) {
+                            found.emplace_back(iter->low(), iter->high());
+                            return true;
+                        },
+                        exclusive
+                    );
+                    ASSERT_EQ(found, bruteForceOverlaps(intervals, query, exclusive))
+                        << "size " << size << ", long interval at " << longIndex << ", query low " << low;
+                }
+            }
+        }
+    }
+}
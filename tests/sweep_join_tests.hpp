@@ -0,0 +1,164 @@
+#pragma once
+
+#include <interval-tree/sweep_overlap_join.hpp>
+
+#include "test_utility.hpp"
+
+#include <algorithm>
+#include <forward_list>
+#include <random>
+#include <stdexcept>
+#include <tuple>
+#include <vector>
+
+class SweepJoinTests : public BruteForceTests
+{
+  protected:
+    template <typename IteratorA, typename IteratorB>
+    static overlap_pair_list
+    sweep(IteratorA first_a, IteratorA last_a, IteratorB first_b, IteratorB last_b, bool exclusive)
+    {
+        overlap_pair_list result;
+        lib_interval_tree::sweep_overlap_join(
+            first_a,
+            last_a,
+            first_b,
+            last_b,
+            [&result](auto const& a, auto const& b) {
+                result.emplace_back(a.low(), a.high(), b.low(), b.high());
+                return true;
+            },
+            exclusive
+        );
+        std::sort(result.begin(), result.end());
+        return result;
+    }
+
+    template <typename IntervalT, typename MakeIntervalT>
+    void compareWithBruteForce(MakeIntervalT const& makeInterval, int lhsCount, int rhsCount)
+    {
+        std::vector<IntervalT> lhs;
+        std::vector<IntervalT> rhs;
+        for (int i = 0; i < lhsCount; ++i)
+            lhs.push_back(makeInterval(distValue(gen), distLength(gen)));
+        for (int i = 0; i < rhsCount; ++i)
+            rhs.push_back(makeInterval(distValue(gen), distLength(gen)));
+        const auto byLow = [](IntervalT const& lhs, IntervalT const& rhs) {
+            return lhs.low() < rhs.low();
+        };
+        std::sort(lhs.begin(), lhs.end(), byLow);
+        std::sort(rhs.begin(), rhs.end(), byLow);
+
+        for (bool exclusive : {false, true})
+        {
+            EXPECT_EQ(
+                sweep(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(), exclusive),
+                bruteForceOverlapPairs(lhs, rhs, exclusive)
+            );
+        }
+    }
+};
+
+TEST_F(SweepJoinTests, EmptyInputsGiveNoPairs)
+{
+    std::vector<lib_interval_tree::interval<int>> empty;
+    std::vector<lib_interval_tree::interval<int>> some{{0, 10}, {5, 20}};
+    EXPECT_TRUE(sweep(empty.begin(), empty.end(), some.begin(), some.end(), false).empty());
+    EXPECT_TRUE(sweep(some.begin(), some.end(), empty.begin(), empty.end(), false).empty());
+}
+
+TEST_F(SweepJoinTests, AllKindsMatchBruteForce)
+{
+    forEachStaticKind([this](auto kind) {
+        using interval_type = typename decltype(kind)::type;
+        compareWithBruteForce<interval_type>(intervalOfLength<interval_type>, 1000, 700);
+        compareWithBruteForce<interval_type>(intervalOfLength<interval_type>, 700, 1000);
+    });
+}
+
+TEST_F(SweepJoinTests, DynamicBordersMatchBruteForce)
+{
+    using namespace lib_interval_tree;
+    std::uniform_int_distribution<int> distBorder{0, 2};
+    compareWithBruteForce<interval<int, dynamic>>(
+        [&](int low, int length) {
+            return interval<int, dynamic>{
+                low,
+                low + length + 2,
+                static_cast<interval_border>(distBorder(gen)),
+                static_cast<interval_border>(distBorder(gen))
+            };
+        },
+        800,
+        800
+    );
+}
+
+TEST_F(SweepJoinTests, MatchesOverlapJoinOfTrees)
+{
+    lib_interval_tree::interval_tree_t<int> lhs;
+    lib_interval_tree::interval_tree_t<int> rhs;
+    for (int i = 0; i < 2000; ++i)
+    {
+        lhs.insert(lib_interval_tree::make_safe_interval(distValue(gen), distValue(gen)));
+        const auto low = distValue(gen);
+        rhs.insert({low, low + distLength(gen)});
+    }
+
+    overlap_pair_list expected;
+    lhs.overlap_join(rhs, [&expected](auto a, auto b) {
+        expected.emplace_back(a->low(), a->high(), b->low(), b->high());
+        return true;
+    });
+    std::sort(expected.begin(), expected.end());
+
+    // In order iteration of a tree is sorted by low.
+    EXPECT_EQ(sweep(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(), false), expected);
+}
+
+TEST_F(SweepJoinTests, WorksOnForwardOnlyInputs)
+{
+    std::forward_list<lib_interval_tree::interval<int>> lhs;
+    std::forward_list<lib_interval_tree::interval<int>> rhs;
+    for (int i = 9999; i >= 0; --i)
+    {
+        lhs.push_front({i * 10, i * 10 + 4});
+        rhs.push_front({i * 10 + 4, i * 10 + 12});
+    }
+
+    const auto pairs = sweep(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(), false);
+    // Every a touches the b that starts at its high and the b that started before it.
+    EXPECT_EQ(pairs.size(), 19999);
+    EXPECT_EQ(sweep(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(), true).size(), 9999);
+}
+
+TEST_F(SweepJoinTests, UnsortedInputThrows)
+{
+    std::vector<lib_interval_tree::interval<int>> lhs{{0, 5}, {10, 15}, {3, 4}};
+    std::vector<lib_interval_tree::interval<int>> rhs{{0, 100}};
+    EXPECT_THROW(sweep(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(), false), std::invalid_argument);
+    EXPECT_THROW(sweep(rhs.begin(), rhs.end(), lhs.begin(), lhs.end(), false), std::invalid_argument);
+}
+
+TEST_F(SweepJoinTests, SweepCanBeStopped)
+{
+    std::vector<lib_interval_tree::interval<int>> lhs;
+    std::vector<lib_interval_tree::interval<int>> rhs;
+    for (int i = 0; i < 100; ++i)
+    {
+        lhs.push_back({i, i + 5});
+        rhs.push_back({i, i + 5});
+    }
+
+    int pairs = 0;
+    lib_interval_tree::sweep_overlap_join(
+        lhs.begin(),
+        lhs.end(),
+        rhs.begin(),
+        rhs.end(),
+        [&pairs](auto const&, auto const&) {
+            return ++pairs < 10;
+        }
+    );
+    EXPECT_EQ(pairs, 10);
+}
@@ -4,9 +4,14 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
 #include <functional>
 #include <list>
 #include <cmath>
+#include <random>
+#include <tuple>
+#include <utility>
+#include <vector>
 
 /**
  *  Warning this function is very expensive.
@@ -115,3 +120,85 @@ void testTreeHeightHealth(TreeT const& tree)
     const auto calc = 2 * std::log2(static_cast<int>(treeSize) + 1);
     EXPECT_LE(maxHeight, calc);
 }
+
+template <typename T>
+struct type_tag
+{
+    using type = T;
+};
+
+/**
+ *  Calls function with a type_tag of interval<int, kind> for every kind with static borders.
+ */
+template <typename FunctionT>
+void forEachStaticKind(FunctionT&& function)
+{
+    using namespace lib_interval_tree;
+    function(type_tag<interval<int, closed>>{});
+    function(type_tag<interval<int, open>>{});
+    function(type_tag<interval<int, left_open>>{});
+    function(type_tag<interval<int, right_open>>{});
+    function(type_tag<interval<int, closed_adjacent>>{});
+}
+
+template <typename IntervalT>
+IntervalT intervalOfLength(int low, int length)
+{
+    return IntervalT{low, low + length};
+}
+
+/**
+ *  Returns low and high of every interval that satisfies predicate, sorted.
+ */
+template <typename RangeT, typename PredicateT>
+std::vector<std::pair<int, int>> bruteForce(RangeT const& intervals, PredicateT const& predicate)
+{
+    std::vector<std::pair<int, int>> result;
+    for (auto const& candidate : intervals)
+    {
+        if (predicate(candidate))
+            result.emplace_back(candidate.low(), candidate.high());
+    }
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+template <typename RangeT, typename IntervalT>
+std::vector<std::pair<int, int>> bruteForceOverlaps(RangeT const& intervals, IntervalT const& ival, bool exclusive)
+{
+    return bruteForce(intervals, [&ival, exclusive](IntervalT const& candidate) {
+        return exclusive ? candidate.overlaps_exclusive(ival) : candidate.overlaps(ival);
+    });
+}
+
+using overlap_pair_list = std::vector<std::tuple<int, int, int, int>>;
+
+/**
+ *  Returns every overlapping pair of an interval of lhs and one of rhs, sorted.
+ */
+template <typename RangeA, typename RangeB>
+overlap_pair_list bruteForceOverlapPairs(RangeA const& lhs, RangeB const& rhs, bool exclusive)
+{
+    overlap_pair_list result;
+    for (auto const& a : lhs)
+    {
+        for (auto const& b : rhs)
+        {
+            if (exclusive ? a.overlaps_exclusive(b) : a.overlaps(b))
+                result.emplace_back(a.low(), a.high(), b.low(), b.high());
+        }
+    }
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+/**
+ *  Base of the tests that compare against one of the brute force references above on random intervals.
+ */
+class BruteForceTests : public ::testing::Test
+{
+  protected:
+    std::default_random_engine gen;
+    std::uniform_int_distribution<int> distValue{0, 5000};
+    std::uniform_int_distribution<int> distLength{0, 30};
+};
@@ -17,6 +17,25 @@
 #include "dot_draw_tests.hpp"
 #include "punch_tests.hpp"
 #include "interval_tests.hpp"
+#include "allocator_tests.hpp"
+#include "arena_tests.hpp"
+#include "index_linked_tests.hpp"
+#include "static_index_tests.hpp"
+#include "bulk_construction_tests.hpp"
+#include "overlap_pruning_tests.hpp"
+#include "stab_tests.hpp"
+#include "batch_query_tests.hpp"
+#include "overlap_join_tests.hpp"
+#include "sweep_join_tests.hpp"
+#include "overlapping_pair_tests.hpp"
+#include "persistent_tree_tests.hpp"
+#include "sharded_tree_tests.hpp"
+#include "concurrent_tree_tests.hpp"
+#include "skip_list_tests.hpp"
+#include "augmentation_tests.hpp"
+#include "counting_tree_tests.hpp"
+#include "order_statistic_tests.hpp"
+#include "covered_length_tests.hpp"
 
 int main(int argc, char** argv)
 {